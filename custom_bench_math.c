@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "custom_math.h"
+
+#define BENCH_TRIALS 7
+#define BENCH_DEFAULT_TRIALS 2   // the iterative default paths are much slower
+#define BENCH_MIN_TRIAL_NS 2e5   // calls per trial grow until a trial is this long
+#define BENCH_MAX_INPUTS 6
+#define BENCH_MAX_SPREAD 2.0     // allowed max/min latency ratio per function
+
+typedef struct {
+  const char *name;
+  long double (*fn)(double, double);
+  double args[BENCH_MAX_INPUTS][2];
+  int n_args;
+} bench_case;
+
+static long double bench_sin(double x, double y) { (void)y; return custom_sin(x); }
+static long double bench_cos(double x, double y) { (void)y; return custom_cos(x); }
+static long double bench_tan(double x, double y) { (void)y; return custom_tan(x); }
+static long double bench_exp(double x, double y) { (void)y; return custom_exp(x); }
+static long double bench_log(double x, double y) { (void)y; return custom_log(x); }
+static long double bench_sqrt(double x, double y) { (void)y; return custom_sqrt(x); }
+static long double bench_atan(double x, double y) { (void)y; return custom_atan(x); }
+static long double bench_asin(double x, double y) { (void)y; return custom_asin(x); }
+static long double bench_acos(double x, double y) { (void)y; return custom_acos(x); }
+static long double bench_pow(double x, double y) { return custom_pow(x, y); }
+static long double bench_factorial(double x, double y) {
+  (void)y;
+  return custom_factorial((int)x);
+}
+
+// Inputs are picked to hit the shortest and longest paths of each function.
+static const bench_case bench_cases[] = {
+    {"sin", bench_sin, {{0.1, 0}, {1.0, 0}, {3.0, 0}, {1000.5, 0}, {1e6, 0}}, 5},
+    {"cos", bench_cos, {{0.1, 0}, {1.0, 0}, {3.0, 0}, {1000.5, 0}, {1e6, 0}}, 5},
+    {"tan", bench_tan, {{0.1, 0}, {1.0, 0}, {3.0, 0}, {1000.5, 0}, {1e6, 0}}, 5},
+    {"exp", bench_exp, {{-700, 0}, {-1, 0}, {1e-3, 0}, {20, 0}, {700, 0}}, 5},
+    {"log", bench_log, {{1e-300, 0}, {0.5, 0}, {2.0, 0}, {1e10, 0}, {1e300, 0}}, 5},
+    {"sqrt", bench_sqrt, {{1e-300, 0}, {0.25, 0}, {2.0, 0}, {1e10, 0}, {1e300, 0}}, 5},
+    {"atan", bench_atan, {{0.01, 0}, {0.5, 0}, {0.99, 0}, {5.0, 0}, {1e10, 0}}, 5},
+    {"asin", bench_asin, {{0.01, 0}, {0.5, 0}, {0.9, 0}, {-0.3, 0}}, 4},
+    {"acos", bench_acos, {{0.01, 0}, {0.5, 0}, {0.9, 0}, {-0.3, 0}}, 4},
+    {"pow", bench_pow, {{2.0, 3.0}, {1.5, 100.0}, {1.0001, 1e9}, {2.5, 0.5}, {10, -7}}, 5},
+    {"factorial", bench_factorial, {{0, 0}, {10, 0}, {170, 0}, {1754, 0}}, 4},
+};
+
+static volatile long double bench_sink;
+
+static double bench_now_ns(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Nanoseconds per call of fn(x, y), over enough calls to fill one trial.
+static double bench_latency(const bench_case *c, double x, double y) {
+  volatile double vx = x, vy = y;
+  double elapsed = 0.0;
+  long calls = 1;
+  do {
+    double start = bench_now_ns();
+    for (long i = 0; i < calls; i++) bench_sink = c->fn(vx, vy);
+    elapsed = bench_now_ns() - start;
+    calls = elapsed < BENCH_MIN_TRIAL_NS ? calls * 2 : calls;
+  } while (elapsed < BENCH_MIN_TRIAL_NS);
+  return elapsed / calls;
+}
+
+/*
+ * Ratio between the slowest and the fastest input of one function. Each
+ * trial visits every input once, so clock changes hit all inputs alike, and
+ * the best trial of each input is kept.
+ */
+static double bench_spread(const bench_case *c, int trials, double *min_ns,
+                           double *max_ns) {
+  double best[BENCH_MAX_INPUTS] = {0};
+  for (int t = 0; t < trials; t++) {
+    for (int i = 0; i < c->n_args; i++) {
+      double ns = bench_latency(c, c->args[i][0], c->args[i][1]);
+      best[i] = t == 0 || ns < best[i] ? ns : best[i];
+    }
+  }
+  *min_ns = best[0];
+  *max_ns = best[0];
+  for (int i = 1; i < c->n_args; i++) {
+    *min_ns = best[i] < *min_ns ? best[i] : *min_ns;
+    *max_ns = best[i] > *max_ns ? best[i] : *max_ns;
+  }
+  return *max_ns / *min_ns;
+}
+
+int main(void) {
+  int failed = 0;
+  size_t n_cases = sizeof(bench_cases) / sizeof(bench_cases[0]);
+  printf("%-10s %12s %12s %8s | %12s %8s\n", "function", "det min ns",
+         "det max ns", "spread", "default max", "spread");
+  for (size_t i = 0; i < n_cases; i++) {
+    double det_min = 0, det_max = 0, def_min = 0, def_max = 0;
+    custom_set_deterministic(1);
+    double det_spread =
+        bench_spread(&bench_cases[i], BENCH_TRIALS, &det_min, &det_max);
+    custom_set_deterministic(0);
+    double def_spread = bench_spread(&bench_cases[i], BENCH_DEFAULT_TRIALS,
+                                     &def_min, &def_max);
+    int ok = det_spread <= BENCH_MAX_SPREAD;
+    failed |= !ok;
+    printf("%-10s %12.1f %12.1f %8.2f | %12.1f %8.2f %s\n", bench_cases[i].name,
+           det_min, det_max, det_spread, def_max, def_spread, ok ? "" : "FAIL");
+  }
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
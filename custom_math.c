@@ -1,5 +1,482 @@
 #include "custom_math.h"
 
+#include <complex.h>
+#include <stdint.h>
+
+// 1 / ln(2) used by the exponential kernel range reduction
+#define CUSTOM_INV_LN2 1.44269504088896338700e+00
+// Four-part split of pi/2 used by the sine/cosine kernel range reduction.
+// The first three parts have at most 23 significant bits, so their products
+// with any quadrant k < 2^30 are exact.
+#define CUSTOM_PIO2_1 1.57079625129699707031e+00
+#define CUSTOM_PIO2_2 7.54978941586159635335e-08
+#define CUSTOM_PIO2_3 5.39030083589187025694e-15
+#define CUSTOM_PIO2_4 2.02226624879595063154e-21
+#define CUSTOM_INV_PIO2 6.36619772367581382433e-01
+#define CUSTOM_TAN_PI_8 0.41421356237309504880
+// Long double constants of the gamma functions
+#define CUSTOM_PI_L 3.14159265358979323846264338327950288L
+#define CUSTOM_LN_PI_L 1.14472988584940017414342735135305871L
+#define CUSTOM_LN_SQRT_2PI_L 0.91893853320467274178032973640561764L
+#define CUSTOM_LN2_L 0.69314718055994530941723212145817657L
+// ln(2) - CUSTOM_LN2_HI, the low part of ln(2) for long double reductions
+#define CUSTOM_LN2_LO_L 1.90821492927058781614426568075500134e-10L
+#define CUSTOM_LDBL_LOG_MAX 11356.5234062941439L  // ln(LDBL_MAX)
+#define CUSTOM_GAMMA_STIRLING_MIN 16  // the Stirling series runs on x >= 16
+#define CUSTOM_GAMMA_TABLE_MAX 25     // largest n! exact in a 64-bit mantissa
+
+// Classes of custom_fpclassify, in increasing order of the bits of |x|
+#define CUSTOM_FP_ZERO 0
+#define CUSTOM_FP_SUBNORMAL 1
+#define CUSTOM_FP_NORMAL 2
+#define CUSTOM_FP_INFINITE 3
+#define CUSTOM_FP_NAN 4
+
+// Class of x as a sum of comparisons on the bits of |x|, without branches.
+static inline int custom_fpclassify(double x) {
+  uint64_t a = custom_abs_bits(x);
+  return (a != 0) + (a >= CUSTOM_DBL_MIN_BITS) + (a >= CUSTOM_DBL_INF_BITS) +
+         (a > CUSTOM_DBL_INF_BITS);
+}
+
+/*
+ * Zero, infinite or NaN. Subtracting 1 wraps zero around to the top, so the
+ * three classes take one unsigned comparison. The entry points test this
+ * once and resolve the special values off the common path.
+ */
+static inline int custom_fp_special(double x) {
+  return custom_abs_bits(x) - 1 >= CUSTOM_DBL_INF_BITS - 1;
+}
+
+// Anything but a positive, finite, non-zero x: the same test on signed bits.
+static inline int custom_fp_not_positive(double x) {
+  custom_dbl_bits b = {0};
+  b.d = x;
+  return b.u - 1 >= CUSTOM_DBL_INF_BITS - 1;
+}
+
+/*
+ * Branch-free e^x for double arguments. x is reduced to k * ln(2) + r with
+ * |r| <= ln(2) / 2, e^r is evaluated by custom_exp_core and 2^k is built
+ * directly in the exponent bits as 2 * 2^(k - 1), since 2^1024 itself is not
+ * a double. Arguments below
+ * CUSTOM_EXP_MIN_ARG give 0, above CUSTOM_EXP_MAX_ARG give infinity.
+ */
+static inline double custom_exp_kernel(double x) {
+  double clamped = x > CUSTOM_EXP_MIN_ARG ? x : CUSTOM_EXP_MIN_ARG;
+  clamped = clamped > CUSTOM_EXP_MAX_ARG ? CUSTOM_EXP_MAX_ARG : clamped;
+  double kd = clamped * CUSTOM_INV_LN2;
+  int64_t k = (int64_t)(kd < 0 ? kd - 0.5 : kd + 0.5);
+  double r = (clamped - (double)k * CUSTOM_LN2_HI) - (double)k * CUSTOM_LN2_LO;
+  double p = custom_exp_core(r);
+  custom_dbl_bits scale = {(uint64_t)(k + 1022) << 52};
+  double res = (2.0 * p) * scale.d;
+  res = x < CUSTOM_EXP_MIN_ARG ? 0.0 : res;
+  res = x > CUSTOM_EXP_MAX_ARG ? CUSTOM_INF_POS : res;
+  return CUSTOM_IS_NAN(x) ? x : res;
+}
+
+/*
+ * Sine and cosine of x from a single range reduction. x is reduced to
+ * k * pi/2 + r with |r| <= pi/4, custom_sin_core and custom_cos_core
+ * are evaluated on r and the quadrant k & 3 then selects signs and swaps.
+ * Accurate for |x| < CUSTOM_TRG_MAX_ARG, outside of it (and for inf or NaN)
+ * gives NaN.
+ */
+static inline void custom_sincos_kernel(double x, double *s, double *c) {
+  double ax = x < 0 ? -x : x;
+  int valid = ax < CUSTOM_TRG_MAX_ARG;
+  double xr = valid ? x : 0.0;
+  double kd = xr * CUSTOM_INV_PIO2;
+  int64_t k = (int64_t)(kd < 0 ? kd - 0.5 : kd + 0.5);
+  double r = xr - (double)k * CUSTOM_PIO2_1;
+  r = r - (double)k * CUSTOM_PIO2_2;
+  r = r - (double)k * CUSTOM_PIO2_3;
+  r = r - (double)k * CUSTOM_PIO2_4;
+  double sr = custom_sin_core(r);
+  double cr = custom_cos_core(r);
+  int q = (int)(k & 3);
+  double s0 = (q & 1) ? cr : sr;
+  double c0 = (q & 1) ? sr : cr;
+  s0 = (q & 2) ? -s0 : s0;
+  c0 = ((q + 1) & 2) ? -c0 : c0;
+  *s = valid ? s0 : CUSTOM_NAN;
+  *c = valid ? c0 : CUSTOM_NAN;
+}
+
+/*
+ * Natural logarithm of a double. Subnormal arguments are scaled by 2^54 into
+ * the domain of custom_log_core and special values replace the result
+ * afterwards, so the series always runs.
+ */
+static inline double custom_log_kernel(double x) {
+  int valid = x > 0 && x < CUSTOM_INF_POS;
+  int subnormal = x < CUSTOM_DBL_MIN;
+  double xs = subnormal ? x * 18014398509481984.0 : x;  // 2^54
+  double e = subnormal ? -54.0 : 0.0;
+  double res = custom_log_core(valid ? xs : 1.0);
+  res = e * CUSTOM_LN2_HI + (res + e * CUSTOM_LN2_LO);
+  res = custom_fp_special(x) ? (x == 0 ? CUSTOM_INF_NEG : x) : res;
+  return x < 0 ? CUSTOM_NAN : res;
+}
+
+/*
+ * Arctangent of t. Arguments above tan(pi/8) are mapped through
+ * atan(t) = pi/4 + atan((t - 1) / (t + 1)) and large ones through
+ * atan(t) = pi/2 - atan(1/t), so the odd series only runs on |u| <= tan(pi/8).
+ */
+static inline double custom_atan_kernel(double t) {
+  double a = t < 0 ? -t : t;
+  int inverted = a > 1.0;
+  double inv = 1.0 / a;
+  a = inverted ? inv : a;
+  int shifted = a > CUSTOM_TAN_PI_8;
+  double moved = (a - 1.0) / (a + 1.0);
+  double u = shifted ? moved : a;
+  double res = custom_atan_core(u == u ? u : 0.0);
+  res = shifted ? CUSTOM_PI / 4 + res : res;
+  res = inverted ? CUSTOM_PI / 2 - res : res;
+  res = CUSTOM_IS_NAN(t) ? t : res;
+  return t < 0 ? -res : res;
+}
+
+// Angle of the point (x, y), the quadrant-aware arctangent of y / x. The
+// half-planes are chosen by sign bit, so signed zeros pick the side of the
+// branch cut as in C99 atan2.
+static inline double custom_atan2_kernel(double y, double x) {
+  double ax = x < 0 ? -x : x, ay = y < 0 ? -y : y;
+  double num = ay < ax ? ay : ax, den = ay < ax ? ax : ay;
+  double ratio = num / den;
+  double t = den == 0 ? 0.0 : (ax == ay ? 1.0 : ratio);
+  double res = custom_atan_kernel(t);
+  res = ay > ax ? CUSTOM_PI / 2 - res : res;
+  res = custom_signbit(x) ? CUSTOM_PI - res : res;
+  return custom_signbit(y) ? -res : res;
+}
+
+/*
+ * Square root of a non-negative double. Subnormal arguments are scaled by
+ * 2^54 into the domain of custom_sqrt_core, zero, infinity and negative
+ * arguments replace the result afterwards.
+ */
+static inline double custom_sqrt_kernel(double x) {
+  int valid = x > 0 && x < CUSTOM_INF_POS;
+  int subnormal = x < CUSTOM_DBL_MIN;
+  double xs = subnormal ? x * 18014398509481984.0 : x;  // 2^54
+  double g = custom_sqrt_core(valid ? xs : 1.0);
+  g = subnormal ? g * 7.450580596923828125e-9 : g;  // 2^-27
+  g = custom_fp_special(x) ? x : g;
+  return x < 0 ? CUSTOM_NAN : g;
+}
+
+/*
+ * x^y on doubles through e^(y ln|x|), with ln|x| already computed so that
+ * callers needing it as well evaluate it once. Negative bases are only
+ * defined for integer exponents, where the sign follows the parity of y. The
+ * sign is taken from the sign bit, so -0 to an odd power stays negative.
+ */
+static inline double custom_pow_from_log(double x, double y, double log_ax) {
+  double ay = y < 0 ? -y : y;
+  int is_int = ay < 9007199254740992.0 && y == (double)(int64_t)y;  // 2^53
+  int odd = is_int && ((int64_t)y & 1);
+  int big_int = ay >= 9007199254740992.0 && ay != CUSTOM_INF_POS;
+  double res = custom_exp_kernel(y * log_ax);
+  res = custom_signbit(x) && odd ? -res : res;
+  res = x < 0 && !is_int && !big_int ? CUSTOM_NAN : res;
+  return y == 0 ? 1.0 : res;
+}
+
+static inline double custom_pow_kernel(double x, double y) {
+  return custom_pow_from_log(x, y, custom_log_kernel(x < 0 ? -x : x));
+}
+
+/*
+ * Hyperbolic sine and cosine of x from one exponential. The sine uses its
+ * Taylor series for |x| < 0.5 where e^x - e^-x would cancel. The exponential
+ * is taken as h = e^|x| / 2 = e^(|x| - ln(2)), with the exact subtraction of
+ * CUSTOM_LN2_HI and the low part applied as a factor, so both stay finite up
+ * to |x| = ln(DBL_MAX) + ln(2).
+ */
+static inline void custom_sinhcosh_kernel(double x, double *sh, double *ch) {
+  double ax = x < 0 ? -x : x;
+  double h = custom_exp_kernel(ax - CUSTOM_LN2_HI) * (1.0 - CUSTOM_LN2_LO);
+  double inv = 0.25 / h;
+  double z = x * x;
+  double p = 1.0 / 1307674368000.0;
+  p = p * z + 1.0 / 6227020800.0;
+  p = p * z + 1.0 / 39916800.0;
+  p = p * z + 1.0 / 362880.0;
+  p = p * z + 1.0 / 5040.0;
+  p = p * z + 1.0 / 120.0;
+  p = p * z + 1.0 / 6.0;
+  double small = x + x * z * p;
+  double large = h - inv;
+  *sh = ax < 0.5 ? small : (x < 0 ? -large : large);
+  *ch = h + inv;
+}
+
+// Complex function cores working on split real and imaginary parts.
+static inline void custom_cexp_core(double a, double b, double *re, double *im) {
+  double e = custom_exp_kernel(a), s = 0.0, c = 0.0;
+  custom_sincos_kernel(b, &s, &c);
+  *re = b == 0 ? e : e * c;
+  *im = b == 0 ? b : e * s;
+}
+
+static inline void custom_clog_core(double a, double b, double *re, double *im) {
+  double ax = a < 0 ? -a : a, ay = b < 0 ? -b : b;
+  double m = ax > ay ? ax : ay, q = ax > ay ? ay / ax : ax / ay;
+  q = ax == ay ? 1.0 : q;
+  double r = custom_log_kernel(m) + 0.5 * custom_log_kernel(1.0 + q * q);
+  *re = CUSTOM_IS_NAN(a) || CUSTOM_IS_NAN(b) ? CUSTOM_NAN : r;
+  *im = custom_atan2_kernel(b, a);
+}
+
+static inline void custom_csqrt_core(double a, double b, double *re, double *im) {
+  double ax = a < 0 ? -a : a, ay = b < 0 ? -b : b;
+  double m = ax > ay ? ax : ay, q = ax > ay ? ay / ax : ax / ay;
+  q = ax == ay ? 1.0 : q;
+  // Tiny and huge arguments are scaled by an even power of two so that the
+  // intermediate sums neither lose precision as subnormals nor overflow.
+  double scale = m < 1e-300 ? 3.2451855365842673e+32 : 1.0;  // 2^108
+  scale = m > 1e300 ? 3.0814879110195774e-33 : scale;        // 2^-108
+  double unscale = m < 1e-300 ? 5.5511151231257827e-17 : 1.0;  // 2^-54
+  unscale = m > 1e300 ? 18014398509481984.0 : unscale;         // 2^54
+  double abs_z = m * scale * custom_sqrt_kernel(1.0 + q * q);
+  double t = custom_sqrt_kernel(0.5 * (ax * scale) + 0.5 * abs_z);
+  double r = a >= 0 ? t : (ay * scale) / (2.0 * t);
+  double i = a >= 0 ? (b * scale) / (2.0 * t) : (custom_signbit(b) ? -t : t);
+  r *= unscale;
+  i *= unscale;
+  r = t == 0 ? 0.0 : r;
+  i = t == 0 ? b : i;
+  *re = ay == CUSTOM_INF_POS ? CUSTOM_INF_POS : r;
+  *im = ay == CUSTOM_INF_POS ? b : i;
+}
+
+static inline void custom_csin_core(double a, double b, double *re, double *im) {
+  double s = 0.0, c = 0.0, sh = 0.0, ch = 0.0;
+  custom_sincos_kernel(a, &s, &c);
+  custom_sinhcosh_kernel(b, &sh, &ch);
+  // sin(a) = 0 gives an exact zero, not 0 * inf for large |b|
+  *re = s == 0 ? s : s * ch;
+  *im = c * sh;
+}
+
+static inline void custom_ccos_core(double a, double b, double *re, double *im) {
+  double s = 0.0, c = 0.0, sh = 0.0, ch = 0.0;
+  custom_sincos_kernel(a, &s, &c);
+  custom_sinhcosh_kernel(b, &sh, &ch);
+  double sh_sign = custom_signbit(sh) ? -1.0 : 1.0;
+  *re = c * ch;
+  *im = s == 0 ? -s * sh_sign : -s * sh;  // as in custom_csin_core
+}
+
+static inline void custom_cpow_core(double a, double b, double c, double d,
+                                    double *re, double *im) {
+  double lr = 0.0, li = 0.0;
+  custom_clog_core(a, b, &lr, &li);
+  custom_cexp_core(c * lr - d * li, c * li + d * lr, re, im);
+  if (a == 0 && b == 0) {
+    *re = c == 0 && d == 0 ? 1.0 : (c > 0 ? 0.0 : CUSTOM_NAN);
+    *im = c == 0 && d == 0 ? 0.0 : (c > 0 ? 0.0 : CUSTOM_NAN);
+  }
+}
+
+// Fixed-point constants, all in Q2.30 unless noted otherwise
+#define CUSTOM_FIX_ONE 1073741824LL
+#define CUSTOM_FIX_CORDIC_GAIN 652032874LL
+#define CUSTOM_FIX_PIO2_Q46 110534964875444LL
+#define CUSTOM_FIX_PI 3373259426LL
+#define CUSTOM_FIX_TWO_OVER_PI_Q31 1367130551LL
+#define CUSTOM_FIX_LN2 744261118LL
+#define CUSTOM_FIX_LOG2E 1549082005LL
+#define CUSTOM_FIX_SQRT2 1518500250LL
+#define CUSTOM_FIX_ITERS 30
+
+// atan(2^-i) in Q2.30 for the CORDIC iterations
+static const int64_t custom_fix_atan_table[CUSTOM_FIX_ITERS] = {
+    843314857, 497837829, 263043837, 133525159, 67021687, 33543516,
+    16775851,  8388437,   4194283,   2097149,   1048576,  524288,
+    262144,    131072,    65536,     32768,     16384,    8192,
+    4096,      2048,      1024,      512,       256,      128,
+    64,        32,        16,        8,         4,        2};
+
+// Index of the highest set bit of x, -1 for 0. Fixed six-step search.
+static inline int custom_fix_msb(uint64_t x) {
+  int msb = x ? 0 : -1;
+  for (int shift = 32; shift > 0; shift >>= 1) {
+    int above = (x >> shift) != 0;
+    msb += above ? shift : 0;
+    x = above ? x >> shift : x;
+  }
+  return msb;
+}
+
+// Narrows a Q2.30 value to Q16.16 with rounding.
+static inline int32_t custom_fix_q30_to_q16(int64_t v) {
+  return (int32_t)((v + (1 << 13)) >> 14);
+}
+
+// Clamps a 64-bit value into the int32_t range.
+static inline int32_t custom_fix_sat(int64_t v) {
+  v = v > INT32_MAX ? INT32_MAX : v;
+  return (int32_t)(v < INT32_MIN ? INT32_MIN : v);
+}
+
+/*
+ * CORDIC rotation of the unit vector by r (Q2.30 radians, |r| <= pi/4) and
+ * the quadrant k & 3, giving sine and cosine in Q2.30. The vector carries 10
+ * extra fractional bits so the truncating shifts do not accumulate.
+ */
+static inline void custom_fix_sincos(int64_t r, int64_t k, int64_t *s,
+                                     int64_t *c) {
+  int64_t x = CUSTOM_FIX_CORDIC_GAIN * (1LL << 10), y = 0;
+  for (int i = 0; i < CUSTOM_FIX_ITERS; i++) {
+    int64_t sgn = r < 0 ? -1 : 1;
+    int64_t nx = x - sgn * (y >> i);
+    y += sgn * (x >> i);
+    x = nx;
+    r -= sgn * custom_fix_atan_table[i];
+  }
+  x = (x + (1 << 9)) >> 10;
+  y = (y + (1 << 9)) >> 10;
+  int q = (int)(k & 3);
+  int64_t s0 = (q & 1) ? x : y;
+  int64_t c0 = (q & 1) ? y : x;
+  *s = (q & 2) ? -s0 : s0;
+  *c = ((q + 1) & 2) ? -c0 : c0;
+}
+
+// Splits a Q16.16 angle into k * pi/2 + r with r in Q2.30.
+static inline int64_t custom_fix_reduce_q16(int32_t x, int64_t *k) {
+  int64_t x46 = (int64_t)x * (1LL << 30);
+  int64_t quot = x46 / CUSTOM_FIX_PIO2_Q46;
+  int64_t r = x46 - quot * CUSTOM_FIX_PIO2_Q46;
+  int up = r > CUSTOM_FIX_PIO2_Q46 / 2, down = r < -CUSTOM_FIX_PIO2_Q46 / 2;
+  r = up ? r - CUSTOM_FIX_PIO2_Q46 : (down ? r + CUSTOM_FIX_PIO2_Q46 : r);
+  *k = quot + up - down;
+  return r / (1LL << 16);
+}
+
+// Splits a Q1.31 angle in units of pi into k * pi/2 + r with r in Q2.30.
+static inline int64_t custom_fix_reduce_q31(int32_t x, int64_t *k) {
+  uint32_t ux = (uint32_t)x;
+  uint32_t quad = (ux + (1U << 29)) >> 30;
+  int64_t rem = (int64_t)(int32_t)(ux - (quad << 30));
+  *k = quad;
+  return rem * CUSTOM_FIX_PI / (1LL << 31);
+}
+
+/*
+ * CORDIC vectoring of (x, y), returning atan2(y, x) in Q2.30 radians. The
+ * vector is normalised to a magnitude around 2^29 and moved to the right
+ * half-plane before the iterations.
+ */
+static inline int64_t custom_fix_atan2(int32_t y, int32_t x) {
+  int64_t ax = x < 0 ? -(int64_t)x : x, ay = y < 0 ? -(int64_t)y : y;
+  int shift = 29 - custom_fix_msb((uint64_t)(ax > ay ? ax : ay));
+  shift = shift < 0 ? 0 : shift;
+  int64_t vx = (int64_t)x * (1LL << shift), vy = (int64_t)y * (1LL << shift);
+  int64_t z = x < 0 ? (y < 0 ? -CUSTOM_FIX_PI : CUSTOM_FIX_PI) : 0;
+  vx = x < 0 ? -vx : vx;
+  vy = x < 0 ? -vy : vy;
+  for (int i = 0; i < CUSTOM_FIX_ITERS; i++) {
+    int64_t sgn = vy < 0 ? -1 : 1;
+    int64_t nx = vx + sgn * (vy >> i);
+    vy -= sgn * (vx >> i);
+    vx = nx;
+    z += sgn * custom_fix_atan_table[i];
+  }
+  return x == 0 && y == 0 ? 0 : z;
+}
+
+// Rounded integer square root of a 64-bit value, one result bit per step.
+static inline uint64_t custom_fix_isqrt(uint64_t v) {
+  uint64_t res = 0;
+  for (int bit = 31; bit >= 0; bit--) {
+    uint64_t cand = res | (1ULL << bit);
+    res = cand * cand <= v ? cand : res;
+  }
+  return v - res * res > res ? res + 1 : res;
+}
+
+/*
+ * e^x for x with frac_bits fractional bits, returned as a Q2.30 mantissa in
+ * [1, 2) and a binary exponent n. x * log2(e) = n + f, and 2^f = e^(f ln 2)
+ * is evaluated with an integer Horner scheme of the degree 11 Taylor
+ * polynomial. |x| must stay below 2^(31 - frac_bits) * 2^20.
+ */
+static inline int64_t custom_fix_exp(int64_t x, int frac_bits, int64_t *n) {
+  static const int64_t coef[] = {1073741824, 1073741824, 536870912, 178956971,
+                                 44739243,   8947849,    1491308,   213044,
+                                 26631,      2959,       296,       27};
+  int64_t unit = 1LL << (frac_bits + 30);
+  int64_t t = x * CUSTOM_FIX_LOG2E;
+  *n = t >= 0 ? t / unit : -((-t + unit - 1) / unit);
+  int64_t f = (t - *n * unit) / (1LL << frac_bits);
+  int64_t g = f * CUSTOM_FIX_LN2 / CUSTOM_FIX_ONE;
+  int64_t p = coef[11];
+  for (int i = 10; i >= 0; i--) p = coef[i] + p * g / CUSTOM_FIX_ONE;
+  return p;
+}
+
+/*
+ * Scales a Q2.30 mantissa by 2^shift with rounding and saturation. Both
+ * shift directions are computed with clamped counts and the result selected.
+ */
+static inline int32_t custom_fix_ldexp(int64_t p, int64_t shift) {
+  int64_t left = shift < 0 ? 0 : (shift > 31 ? 31 : shift);
+  int64_t right = shift > 0 ? 0 : (shift < -61 ? 61 : -shift);
+  int64_t up = shift > 31 ? INT64_MAX : p * (1LL << left);
+  int64_t down = (p + ((1LL << right) >> 1)) >> right;
+  int64_t res = shift >= 0 ? up : (shift > -62 ? down : 0);
+  return custom_fix_sat(res);
+}
+
+/*
+ * Natural logarithm of v * 2^-frac_bits for v > 0, in Q2.30. v is normalised
+ * to m * 2^e with m in [sqrt(2)/2, sqrt(2)) and ln(m) comes from the atanh
+ * series in s = (m - 1) / (m + 1).
+ */
+static inline int64_t custom_fix_log(uint32_t v, int frac_bits) {
+  int msb = custom_fix_msb(v);
+  int64_t m = (int64_t)v * (1LL << (30 - msb));
+  int shift = m > CUSTOM_FIX_SQRT2;
+  m = shift ? m / 2 : m;
+  int64_t e = msb + shift - frac_bits;
+  int64_t s = (m - CUSTOM_FIX_ONE) * CUSTOM_FIX_ONE / (m + CUSTOM_FIX_ONE);
+  int64_t z = s * s / CUSTOM_FIX_ONE;
+  int64_t p = CUSTOM_FIX_ONE / 15;
+  for (int i = 13; i >= 1; i -= 2) p = CUSTOM_FIX_ONE / i + p * z / CUSTOM_FIX_ONE;
+  return e * CUSTOM_FIX_LN2 + 2 * s * p / CUSTOM_FIX_ONE;
+}
+
+/*
+ * Scans x for its maximum, ignoring NaN elements. Returns 1 if any NaN was
+ * found. The loop body has no data-dependent branches.
+ */
+static int custom_array_max(const double *x, size_t n, double *max) {
+  double m = CUSTOM_INF_NEG;
+  int has_nan = 0;
+  for (size_t i = 0; i < n; i++) {
+    m = x[i] > m ? x[i] : m;
+    has_nan |= CUSTOM_IS_NAN(x[i]);
+  }
+  *max = m;
+  return has_nan;
+}
+
+#ifdef CUSTOM_MATH_DETERMINISTIC
+static int custom_deterministic = 1;
+#else
+static int custom_deterministic = 0;
+#endif
+
+void custom_set_deterministic(int enabled) { custom_deterministic = enabled != 0; }
+
+int custom_is_deterministic(void) { return custom_deterministic; }
+
 int custom_abs(int x) { return x < 0 ? -x : x; }
 
 long double custom_fabs(double x) {
@@ -18,19 +495,185 @@ long double custom_fabsl(long double x) {
   return long_x;
 }
 
+// n! for n <= CUSTOM_GAMMA_TABLE_MAX
+static const long double custom_factorial_table[CUSTOM_GAMMA_TABLE_MAX + 1] = {
+    1.0L,
+    1.0L,
+    2.0L,
+    6.0L,
+    24.0L,
+    120.0L,
+    720.0L,
+    5040.0L,
+    40320.0L,
+    362880.0L,
+    3628800.0L,
+    39916800.0L,
+    479001600.0L,
+    6227020800.0L,
+    87178291200.0L,
+    1307674368000.0L,
+    20922789888000.0L,
+    355687428096000.0L,
+    6402373705728000.0L,
+    121645100408832000.0L,
+    2432902008176640000.0L,
+    51090942171709440000.0L,
+    1124000727777607680000.0L,
+    25852016738884976640000.0L,
+    620448401733239439360000.0L,
+    15511210043330985984000000.0L};
+
+/*
+ * Natural logarithm of a positive long double below the double overflow
+ * threshold. The nearest double d is split into 2^e * m from its bits, log(m)
+ * is the atanh series in long double and log(x / d) ~ (x - d) / d adds back
+ * the bits lost in the conversion.
+ */
+static long double custom_ldbl_log(long double x) {
+  long double e = 0;
+  while (x < CUSTOM_DBL_MIN) {
+    x *= 18014398509481984.0L;  // 2^54
+    e -= 54;
+  }
+  double d = (double)x;
+  custom_dbl_bits b = {0};
+  b.d = d;
+  e += (long double)((int64_t)((b.u >> 52) & 0x7ff) - 1023);
+  b.u = (b.u & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+  long double m = b.d;
+  if (m > CUSTOM_SQRT2) {
+    m *= 0.5L;
+    e += 1;
+  }
+  long double s = (m - 1.0L) / (m + 1.0L);
+  long double z = s * s;
+  long double p = 1.0L / 29.0L;
+  for (int i = 27; i >= 1; i -= 2) p = p * z + 1.0L / i;
+  return e * CUSTOM_LN2_L + (2.0L * s * p + (x - d) / d);
+}
+
+/*
+ * e^y for long double y <= CUSTOM_LDBL_LOG_MAX. y is reduced to k * ln(2) + r
+ * with |r| <= ln(2) / 2, e^r is a degree 20 Taylor polynomial and 2^k is
+ * built by repeated squaring.
+ */
+static long double custom_ldbl_exp(long double y) {
+  if (y > CUSTOM_LDBL_LOG_MAX) return CUSTOM_INF_POS;
+  long double kd = y / CUSTOM_LN2_L;
+  int k = (int)(kd < 0 ? kd - 0.5L : kd + 0.5L);
+  long double r = (y - k * (long double)CUSTOM_LN2_HI) - k * CUSTOM_LN2_LO_L;
+  long double p = 1.0L;
+  for (int i = 20; i >= 1; i--) p = 1.0L + p * r / i;
+  long double base = k < 0 ? 0.5L : 2.0L;
+  unsigned n = k < 0 ? -k : k;
+  if (k > 0) {
+    p *= 2.0L;  // 2^k as 2 * 2^(k - 1), 2^16384 itself is not a long double
+    n--;
+  }
+  for (; n; n >>= 1) {
+    if (n & 1) p *= base;
+    base *= base;
+  }
+  return p;
+}
+
+/*
+ * log(gamma(x)) for x >= CUSTOM_GAMMA_STIRLING_MIN from the Stirling series
+ * (x - 1/2) log(x) - x + log(2 pi) / 2 + sum B_2k / (2k (2k - 1) x^(2k - 1)),
+ * whose eight terms are below 1e-19 from x = 16 on.
+ */
+static long double custom_lgamma_stirling(long double x) {
+  static const long double coef[] = {
+      1.0L / 12.0L,    -1.0L / 360.0L,        1.0L / 1260.0L, -1.0L / 1680.0L,
+      1.0L / 1188.0L,  -691.0L / 360360.0L,   1.0L / 156.0L,
+      -3617.0L / 122400.0L};
+  long double w = 1.0L / x, z = w * w;
+  long double series = coef[7];
+  for (int i = 6; i >= 0; i--) series = series * z + coef[i];
+  return (x - 0.5L) * custom_ldbl_log(x) - x + CUSTOM_LN_SQRT_2PI_L +
+         series * w;
+}
+
+/*
+ * gamma(x) and log(gamma(x)) for x >= 1/2. Integers up to
+ * CUSTOM_GAMMA_TABLE_MAX + 1 come from the factorial table, smaller
+ * arguments are shifted up to the Stirling range with
+ * gamma(x) = gamma(x + n) / (x (x + 1) ... (x + n - 1)).
+ */
+static long double custom_gamma_positive(long double x, int want_log) {
+  if (x <= CUSTOM_GAMMA_TABLE_MAX + 1 && x == (long double)(int)x) {
+    long double f = custom_factorial_table[(int)x - 1];
+    return want_log ? custom_ldbl_log(f) : f;
+  }
+  long double prod = 1.0L;
+  while (x < CUSTOM_GAMMA_STIRLING_MIN) {
+    prod *= x;
+    x += 1.0L;
+  }
+  long double lg = custom_lgamma_stirling(x);
+  if (want_log) return lg - custom_ldbl_log(prod);
+  return custom_ldbl_exp(lg) / prod;
+}
+
+/*
+ * sin(pi * x) for finite x with the integer part of x removed exactly first,
+ * so poles of the reflection formula are found without rounding.
+ */
+static long double custom_sinpi(double x) {
+  double ax = x < 0 ? -x : x;
+  if (ax >= 4503599627370496.0) return 0.0L;  // 2^52, x is an integer
+  int64_t k = (int64_t)(x < 0 ? x - 0.5 : x + 0.5);
+  long double t = CUSTOM_PI_L * (x - (double)k);
+  long double z = t * t, term = t, res = t;
+  for (int i = 1; i <= 14; i++) {
+    term *= -z / ((2 * i) * (2 * i + 1));
+    res += term;
+  }
+  return (k & 1) ? -res : res;
+}
+
+long double custom_tgamma(double x) {
+  if (custom_fp_special(x)) {
+    int cls = custom_fpclassify(x);
+    return cls == CUSTOM_FP_ZERO ? 1.0 / x
+                                 : (x == CUSTOM_INF_NEG ? CUSTOM_NAN : x);
+  }
+  if (x >= 0.5) return custom_gamma_positive(x, 0);
+  long double s = custom_sinpi(x);
+  if (s == 0) return CUSTOM_NAN;
+  return CUSTOM_PI_L / (s * custom_gamma_positive(1.0L - x, 0));
+}
+
+long double custom_lgamma(double x) {
+  if (custom_fp_special(x)) return custom_isnan(x) ? x : CUSTOM_INF_POS;
+  if (x >= 0.5) return custom_gamma_positive(x, 1);
+  long double s = custom_sinpi(x);
+  if (s == 0) return CUSTOM_INF_POS;
+  s = s < 0 ? -s : s;
+  return CUSTOM_LN_PI_L - custom_ldbl_log(s) -
+         custom_gamma_positive(1.0L - x, 1);
+}
+
 long double custom_factorial(int x) {
   if (x < 0) {
     return CUSTOM_NAN;
   }
-  long double result = 1;
-  for (int i = 2; i <= x; ++i) {
-    result *= i;
+  if (custom_deterministic) {
+    // the Stirling path runs for every x so table entries cost the same
+    int in_table = x <= CUSTOM_GAMMA_TABLE_MAX;
+    long double arg = in_table ? CUSTOM_GAMMA_STIRLING_MIN : x + 1.0L;
+    long double general = custom_ldbl_exp(custom_lgamma_stirling(arg));
+    return in_table ? custom_factorial_table[in_table ? x : 0] : general;
   }
-  return result;
+  if (x <= CUSTOM_GAMMA_TABLE_MAX) {
+    return custom_factorial_table[x];
+  }
+  return custom_tgamma(x + 1.0);
 }
 
 long double custom_floor(double x) {
-  if (CUSTOM_IS_NAN(x) || x == CUSTOM_INF_NEG || x == CUSTOM_INF_POS) return x;
+  if (!custom_isfinite(x)) return x;
   long double answer = 0.0;
   if (x >= 0 || (long)x == x) {
     answer = (long)x;
@@ -41,7 +684,7 @@ long double custom_floor(double x) {
 }
 
 long double custom_ceil(double x) {
-  if (CUSTOM_IS_NAN(x) || x == CUSTOM_INF_NEG || x == CUSTOM_INF_POS) return x;
+  if (!custom_isfinite(x)) return x;
   long double answer = 0.0;
   if (x <= 0 || (long)x == x) {
     answer = (long)x;
@@ -52,26 +695,46 @@ long double custom_ceil(double x) {
 }
 
 long double custom_fmod(double x, double y) {
-  long double answer = CUSTOM_NAN;
-  if (y != 0.0) {
-    long double trash = x / y;
-    trash = (trash > 0.0) ? custom_floor(trash) : custom_ceil(trash);
-    answer = x - trash * y;
+  if (custom_fp_special(x) | custom_fp_special(y)) {
+    // infinite or NaN x, zero or NaN y give NaN, the rest keeps x
+    int invalid = (custom_abs_bits(x) >= CUSTOM_DBL_INF_BITS) |
+                  custom_isnan(y) | (y == 0);
+    return invalid ? CUSTOM_NAN : x;
   }
-  return answer;
+  long double trash = x / y;
+  trash = (trash > 0.0) ? custom_floor(trash) : custom_ceil(trash);
+  return x - trash * y;
 }
 
 long double custom_pow(double base, double exp) {
-  if (!exp) return 1;
-  if (base == CUSTOM_INF_NEG && exp == CUSTOM_INF_NEG) return 0;
-  if (base == CUSTOM_INF_NEG && exp == CUSTOM_INF_POS) return CUSTOM_INF_POS;
-  if (base < 0 && exp != (long long int)exp) return CUSTOM_NAN;
+  if (custom_fp_special(base) | custom_fp_special(exp)) {
+    // the kernel covers zeros and infinities, only |base| = 1 needs a fix
+    double abs_base = base < 0 ? -base : base;
+    int inf_exp = custom_isinf(exp);
+    double res = custom_pow_kernel(inf_exp ? abs_base : base, exp);
+    res = abs_base == 1 && inf_exp ? 1.0 : res;
+    return base == 1 ? 1.0 : res;
+  }
   long double lbase = (long double)base, lexp = (long double)exp;
   long double res = 1.0;
-  if (lexp == 0 || lbase == 1) {
-    res = 1.0;
-  } else if (lbase == -1 && (lexp == CUSTOM_INF_POS || lexp == CUSTOM_INF_NEG)) {
+  if (lbase == 1) {
     res = 1.0;
+  } else if (custom_deterministic) {
+    // Small integer exponents use 10 squaring steps in double, which keeps
+    // results such as 2^3 exact, everything else goes through exp and log.
+    // Both paths always run so the cost does not depend on the exponent.
+    double abs_exp = exp < 0 ? -exp : exp;
+    int bits = abs_exp < 1024 ? (int)abs_exp : 0;
+    double dbase = exp < 0 ? 1.0 / base : base, dres = 1.0;
+    for (int i = 0; i < 10; i++) {
+      // selection by index rather than by branch
+      double factor[2] = {1.0, dbase};
+      dres *= factor[(bits >> i) & 1];
+      // squaring past the top bit would run into slow subnormals
+      dbase *= factor[(bits >> (i + 1)) != 0];
+    }
+    double general = custom_pow_kernel(base, exp);
+    res = abs_exp < 1024 && bits == abs_exp ? dres : general;
   } else if ((long long)lexp == lexp) {
     if (lexp < 0) {
       lbase = 1.0 / lbase;
@@ -93,9 +756,12 @@ long double custom_pow(double base, double exp) {
 }
 
 long double custom_acos(double x) {
-  if (x < -1.0 || x > 1.0) {
+  if (custom_abs_bits(x) > CUSTOM_DBL_ONE_BITS) {
     return CUSTOM_NAN;
   }
+  if (custom_deterministic) {
+    return custom_atan2_kernel(custom_sqrt_kernel((1.0 - x) * (1.0 + x)), x);
+  }
   if (x == 1.0) {
     return 0.0;
   }
@@ -122,9 +788,12 @@ long double custom_acos(double x) {
 }
 
 long double custom_asin(double x) {
-  if (x < -1.0 || x > 1.0) {
+  if (custom_abs_bits(x) > CUSTOM_DBL_ONE_BITS) {
     return CUSTOM_NAN;
   }
+  if (custom_deterministic) {
+    return custom_atan2_kernel(x, custom_sqrt_kernel((1.0 - x) * (1.0 + x)));
+  }
   if (x == -1.0) {
     return -CUSTOM_PI / 2;
   }
@@ -144,18 +813,21 @@ long double custom_asin(double x) {
 }
 
 long double custom_atan(double x) {
-  if (x == CUSTOM_INF_POS) return CUSTOM_PI / 2;
-  if (x == CUSTOM_INF_NEG) return -CUSTOM_PI / 2;
-  if (x != x) return x;
-  if (x == 1) return CUSTOM_ATAN_ONE_PLUS;
-  if (x == -1) return CUSTOM_ATAN_ONE_MINUS;
+  if (custom_deterministic) return custom_atan_kernel(x);
+  uint64_t abs_bits = custom_abs_bits(x);
+  if ((abs_bits == CUSTOM_DBL_ONE_BITS) | (abs_bits >= CUSTOM_DBL_INF_BITS)) {
+    // the series converges too slowly at |x| = 1, the kernel handles the rest
+    double one = x > 0 ? CUSTOM_ATAN_ONE_PLUS : CUSTOM_ATAN_ONE_MINUS;
+    return abs_bits == CUSTOM_DBL_ONE_BITS ? one : custom_atan_kernel(x);
+  }
   int is_in_range = (x > -1 && x < 1);
-  long double res = is_in_range ? x : 1.0 / x;
-  long double x_pow = x;
+  long double base = is_in_range ? x : 1.0 / x;
+  long double res = base;
+  long double x_pow = base;
   long double term = CUSTOM_INF_POS;
   int sign = -1;
   for (int i = 3; custom_fabsl(term) > CUSTOM_PRC || i == 3; i += 2) {
-    x_pow *= x * x;
+    x_pow *= base * base;
     term = x_pow / i;
     res += sign * term;
     sign = -sign;
@@ -169,6 +841,12 @@ long double custom_atan(double x) {
 }
 
 long double custom_cos(double x) {
+  if (custom_deterministic) {
+    double s = 0.0, c = 0.0;
+    custom_sincos_kernel(x, &s, &c);
+    return c;
+  }
+  if (!custom_isfinite(x)) return CUSTOM_NAN;
   const int terms = 50;
   long double cos = 1.0;
   long double term = 1.0;
@@ -186,6 +864,12 @@ long double custom_cos(double x) {
 }
 
 long double custom_sin(const double x) {
+  if (custom_deterministic) {
+    double s = 0.0, c = 0.0;
+    custom_sincos_kernel(x, &s, &c);
+    return s;
+  }
+  if (!custom_isfinite(x)) return CUSTOM_NAN;
   long double base = (long double)x;
   int shifted = custom_trg_norm(&base);
   long double res = base;
@@ -199,6 +883,9 @@ long double custom_sin(const double x) {
 }
 
 long double custom_exp(double x) {
+  if (custom_deterministic || custom_fp_special(x)) {
+    return custom_exp_kernel(x);
+  }
   long double exp_res = 1;
   long double add = 1;
   long double i = 1;
@@ -223,10 +910,9 @@ long double custom_exp(double x) {
 }
 
 long double custom_log(double x) {
-  if (x < 0) return CUSTOM_NAN;
-  if (x == 0) return CUSTOM_INF_NEG;
-  if (x == CUSTOM_INF_POS) return CUSTOM_INF_POS;
-  if (x == 1) return 0;
+  if (custom_deterministic || custom_fp_not_positive(x)) {
+    return custom_log_kernel(x);
+  }
   long double base = (long double)x;
   long double res = 0.0;
   int power = 0;
@@ -247,10 +933,9 @@ long double custom_log(double x) {
 }
 
 long double custom_sqrt(double x) {
-  if (CUSTOM_IS_NAN(x)) return CUSTOM_NAN;
-  if (x < 0) return CUSTOM_NAN;
-  if ((x == CUSTOM_INF_POS || x == CUSTOM_INF_NEG) && x > 0) return CUSTOM_INF_POS;
-  if (x == 0) return 0;
+  if (custom_deterministic || custom_fp_not_positive(x)) {
+    return custom_sqrt_kernel(x);
+  }
 
   long double xn = x;
   long double xn1 = (x + 1) / 2.0;
@@ -262,6 +947,12 @@ long double custom_sqrt(double x) {
 }
 
 long double custom_tan(double x) {
+  if (custom_deterministic) {
+    double s = 0.0, c = 0.0;
+    custom_sincos_kernel(x, &s, &c);
+    return c == 0 ? CUSTOM_NAN : s / c;
+  }
+  if (!custom_isfinite(x)) return CUSTOM_NAN;
   x = custom_fmod(x, CUSTOM_PI);
   return (custom_cos(x) == 0) ? CUSTOM_NAN : custom_sin(x) / custom_cos(x);
 }
@@ -274,4 +965,581 @@ int custom_trg_norm(long double *phi) {
     shifted = 1;
   }
   return shifted;
-}
\ No newline at end of file
+}
+
+long double custom_logsumexp(const double *x, size_t n) {
+  double m = CUSTOM_INF_NEG;
+  if (custom_array_max(x, n, &m)) return CUSTOM_NAN;
+  if (m == CUSTOM_INF_NEG || m == CUSTOM_INF_POS) return m;
+  double sum = 0.0, comp = 0.0;
+  for (size_t i = 0; i < n; i++) {
+    double y = custom_exp_kernel(x[i] - m) - comp;
+    double t = sum + y;
+    comp = (t - sum) - y;
+    sum = t;
+  }
+  return m + custom_log_kernel(sum);
+}
+
+void custom_softmax(const double *x, double *out, size_t n) {
+  double m = CUSTOM_INF_NEG;
+  if (custom_array_max(x, n, &m)) {
+    for (size_t i = 0; i < n; i++) out[i] = CUSTOM_NAN;
+  } else if (m == CUSTOM_INF_NEG) {
+    for (size_t i = 0; i < n; i++) out[i] = 1.0 / (double)n;
+  } else if (m == CUSTOM_INF_POS) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) count += x[i] == CUSTOM_INF_POS;
+    for (size_t i = 0; i < n; i++) {
+      out[i] = x[i] == CUSTOM_INF_POS ? 1.0 / (double)count : 0.0;
+    }
+  } else {
+    double sum = 0.0, comp = 0.0;
+    for (size_t i = 0; i < n; i++) {
+      out[i] = custom_exp_kernel(x[i] - m);
+      double y = out[i] - comp;
+      double t = sum + y;
+      comp = (t - sum) - y;
+      sum = t;
+    }
+    double inv = 1.0 / sum;
+    for (size_t i = 0; i < n; i++) out[i] *= inv;
+  }
+}
+
+double complex custom_cexp(double complex z) {
+  double re = 0.0, im = 0.0;
+  custom_cexp_core(creal(z), cimag(z), &re, &im);
+  return CMPLX(re, im);
+}
+
+double complex custom_clog(double complex z) {
+  double re = 0.0, im = 0.0;
+  custom_clog_core(creal(z), cimag(z), &re, &im);
+  return CMPLX(re, im);
+}
+
+double complex custom_cpow(double complex z, double complex w) {
+  double re = 0.0, im = 0.0;
+  custom_cpow_core(creal(z), cimag(z), creal(w), cimag(w), &re, &im);
+  return CMPLX(re, im);
+}
+
+double complex custom_csin(double complex z) {
+  double re = 0.0, im = 0.0;
+  custom_csin_core(creal(z), cimag(z), &re, &im);
+  return CMPLX(re, im);
+}
+
+double complex custom_ccos(double complex z) {
+  double re = 0.0, im = 0.0;
+  custom_ccos_core(creal(z), cimag(z), &re, &im);
+  return CMPLX(re, im);
+}
+
+double complex custom_csqrt(double complex z) {
+  double re = 0.0, im = 0.0;
+  custom_csqrt_core(creal(z), cimag(z), &re, &im);
+  return CMPLX(re, im);
+}
+
+void custom_cexp_array(const double complex *z, double complex *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    double re = 0.0, im = 0.0;
+    custom_cexp_core(creal(z[i]), cimag(z[i]), &re, &im);
+    out[i] = CMPLX(re, im);
+  }
+}
+
+void custom_cexp_split(const double *re, const double *im, double *out_re,
+                       double *out_im, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    custom_cexp_core(re[i], im[i], &out_re[i], &out_im[i]);
+  }
+}
+
+void custom_clog_array(const double complex *z, double complex *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    double re = 0.0, im = 0.0;
+    custom_clog_core(creal(z[i]), cimag(z[i]), &re, &im);
+    out[i] = CMPLX(re, im);
+  }
+}
+
+void custom_clog_split(const double *re, const double *im, double *out_re,
+                       double *out_im, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    custom_clog_core(re[i], im[i], &out_re[i], &out_im[i]);
+  }
+}
+
+void custom_csin_array(const double complex *z, double complex *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    double re = 0.0, im = 0.0;
+    custom_csin_core(creal(z[i]), cimag(z[i]), &re, &im);
+    out[i] = CMPLX(re, im);
+  }
+}
+
+void custom_csin_split(const double *re, const double *im, double *out_re,
+                       double *out_im, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    custom_csin_core(re[i], im[i], &out_re[i], &out_im[i]);
+  }
+}
+
+void custom_ccos_array(const double complex *z, double complex *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    double re = 0.0, im = 0.0;
+    custom_ccos_core(creal(z[i]), cimag(z[i]), &re, &im);
+    out[i] = CMPLX(re, im);
+  }
+}
+
+void custom_ccos_split(const double *re, const double *im, double *out_re,
+                       double *out_im, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    custom_ccos_core(re[i], im[i], &out_re[i], &out_im[i]);
+  }
+}
+
+void custom_csqrt_array(const double complex *z, double complex *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    double re = 0.0, im = 0.0;
+    custom_csqrt_core(creal(z[i]), cimag(z[i]), &re, &im);
+    out[i] = CMPLX(re, im);
+  }
+}
+
+void custom_csqrt_split(const double *re, const double *im, double *out_re,
+                        double *out_im, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    custom_csqrt_core(re[i], im[i], &out_re[i], &out_im[i]);
+  }
+}
+
+void custom_cpow_array(const double complex *z, const double complex *w,
+                       double complex *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    double re = 0.0, im = 0.0;
+    custom_cpow_core(creal(z[i]), cimag(z[i]), creal(w[i]), cimag(w[i]), &re,
+                     &im);
+    out[i] = CMPLX(re, im);
+  }
+}
+
+void custom_cpow_split(const double *re, const double *im, const double *w_re,
+                       const double *w_im, double *out_re, double *out_im,
+                       size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    custom_cpow_core(re[i], im[i], w_re[i], w_im[i], &out_re[i], &out_im[i]);
+  }
+}
+
+int32_t custom_sin_q16(int32_t x) {
+  int64_t k = 0, s = 0, c = 0;
+  int64_t r = custom_fix_reduce_q16(x, &k);
+  custom_fix_sincos(r, k, &s, &c);
+  return custom_fix_q30_to_q16(s);
+}
+
+int32_t custom_cos_q16(int32_t x) {
+  int64_t k = 0, s = 0, c = 0;
+  int64_t r = custom_fix_reduce_q16(x, &k);
+  custom_fix_sincos(r, k, &s, &c);
+  return custom_fix_q30_to_q16(c);
+}
+
+int32_t custom_sqrt_q16(int32_t x) {
+  uint64_t root = custom_fix_isqrt((uint64_t)(x < 0 ? 0 : x) << 16);
+  return x < 0 ? INT32_MIN : (int32_t)root;
+}
+
+int32_t custom_exp_q16(int32_t x) {
+  int64_t n = 0;
+  int64_t p = custom_fix_exp(x, 16, &n);
+  int32_t res = custom_fix_ldexp(p, n - 14);
+  res = x > (11 << 16) ? INT32_MAX : res;
+  return x < -(12 << 16) ? 0 : res;
+}
+
+int32_t custom_log_q16(int32_t x) {
+  int64_t l = custom_fix_log((uint32_t)(x > 0 ? x : 1), 16);
+  return x <= 0 ? INT32_MIN : custom_fix_q30_to_q16(l);
+}
+
+int32_t custom_atan2_q16(int32_t y, int32_t x) {
+  return custom_fix_q30_to_q16(custom_fix_atan2(y, x));
+}
+
+int32_t custom_sin_q31(int32_t x) {
+  int64_t k = 0, s = 0, c = 0;
+  int64_t r = custom_fix_reduce_q31(x, &k);
+  custom_fix_sincos(r, k, &s, &c);
+  return custom_fix_sat(s * 2);
+}
+
+int32_t custom_cos_q31(int32_t x) {
+  int64_t k = 0, s = 0, c = 0;
+  int64_t r = custom_fix_reduce_q31(x, &k);
+  custom_fix_sincos(r, k, &s, &c);
+  return custom_fix_sat(c * 2);
+}
+
+int32_t custom_sqrt_q31(int32_t x) {
+  uint64_t root = custom_fix_isqrt((uint64_t)(x < 0 ? 0 : x) << 31);
+  return x < 0 ? INT32_MIN : custom_fix_sat((int64_t)root);
+}
+
+int32_t custom_exp_q31(int32_t x) {
+  int64_t n = 0;
+  int64_t p = custom_fix_exp(x, 31, &n);
+  return custom_fix_ldexp(p, n + 1);
+}
+
+int32_t custom_log_q31(int32_t x) {
+  int64_t l = custom_fix_log((uint32_t)(x > 0 ? x : 1), 31);
+  return x <= 0 ? INT32_MIN : custom_fix_sat(l * 2);
+}
+
+int32_t custom_atan2_q31(int32_t y, int32_t x) {
+  return custom_fix_sat(custom_fix_atan2(y, x) * CUSTOM_FIX_TWO_OVER_PI_Q31 /
+                        (1LL << 31));
+}
+
+void custom_sin_q16_array(const int32_t *x, int32_t *out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = custom_sin_q16(x[i]);
+}
+
+void custom_cos_q16_array(const int32_t *x, int32_t *out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = custom_cos_q16(x[i]);
+}
+
+void custom_sqrt_q16_array(const int32_t *x, int32_t *out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = custom_sqrt_q16(x[i]);
+}
+
+void custom_exp_q16_array(const int32_t *x, int32_t *out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = custom_exp_q16(x[i]);
+}
+
+void custom_log_q16_array(const int32_t *x, int32_t *out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = custom_log_q16(x[i]);
+}
+
+void custom_atan2_q16_array(const int32_t *y, const int32_t *x, int32_t *out,
+                            size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = custom_atan2_q16(y[i], x[i]);
+}
+
+void custom_sin_q31_array(const int32_t *x, int32_t *out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = custom_sin_q31(x[i]);
+}
+
+void custom_cos_q31_array(const int32_t *x, int32_t *out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = custom_cos_q31(x[i]);
+}
+
+void custom_sqrt_q31_array(const int32_t *x, int32_t *out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = custom_sqrt_q31(x[i]);
+}
+
+void custom_exp_q31_array(const int32_t *x, int32_t *out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = custom_exp_q31(x[i]);
+}
+
+void custom_log_q31_array(const int32_t *x, int32_t *out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = custom_log_q31(x[i]);
+}
+
+void custom_atan2_q31_array(const int32_t *y, const int32_t *x, int32_t *out,
+                            size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = custom_atan2_q31(y[i], x[i]);
+}
+
+int custom_expr_build(custom_expr *expr, const custom_expr_op *ops,
+                      size_t n_ops) {
+  if (n_ops == 0 || n_ops > CUSTOM_EXPR_MAX_OPS) return 1;
+  int depth = 0, error = 0;
+  for (size_t i = 0; i < n_ops && !error; i++) {
+    custom_expr_code code = ops[i].code;
+    if (code == CUSTOM_EXPR_INPUT || code == CUSTOM_EXPR_CONST) {
+      depth++;
+      error = depth > CUSTOM_EXPR_MAX_DEPTH;
+    } else if (code >= CUSTOM_EXPR_ADD && code <= CUSTOM_EXPR_POW) {
+      error = depth < 2;
+      depth--;
+    } else if (code >= CUSTOM_EXPR_NEG && code <= CUSTOM_EXPR_ATAN) {
+      error = depth < 1;
+    } else {
+      error = 1;
+    }
+    if (code == CUSTOM_EXPR_INPUT) {
+      error |= ops[i].input < 0 || ops[i].input >= CUSTOM_EXPR_MAX_INPUTS;
+    }
+  }
+  if (error || depth != 1) return 1;
+  for (size_t i = 0; i < n_ops; i++) expr->ops[i] = ops[i];
+  expr->n_ops = n_ops;
+  return 0;
+}
+
+void custom_expr_eval(const custom_expr *expr, const double *const *inputs,
+                      double *out, size_t n) {
+  double stack[CUSTOM_EXPR_MAX_DEPTH][CUSTOM_EXPR_TILE];
+  for (size_t start = 0; start < n; start += CUSTOM_EXPR_TILE) {
+    size_t len = n - start < CUSTOM_EXPR_TILE ? n - start : CUSTOM_EXPR_TILE;
+    int top = -1;
+    for (size_t k = 0; k < expr->n_ops; k++) {
+      const custom_expr_op *op = &expr->ops[k];
+      if (op->code == CUSTOM_EXPR_INPUT || op->code == CUSTOM_EXPR_CONST) top++;
+      double *a = stack[top > 0 ? top - 1 : 0], *b = stack[top];
+      switch (op->code) {
+        case CUSTOM_EXPR_INPUT:
+          for (size_t i = 0; i < len; i++) b[i] = inputs[op->input][start + i];
+          break;
+        case CUSTOM_EXPR_CONST:
+          for (size_t i = 0; i < len; i++) b[i] = op->value;
+          break;
+        case CUSTOM_EXPR_ADD:
+          for (size_t i = 0; i < len; i++) a[i] += b[i];
+          break;
+        case CUSTOM_EXPR_SUB:
+          for (size_t i = 0; i < len; i++) a[i] -= b[i];
+          break;
+        case CUSTOM_EXPR_MUL:
+          for (size_t i = 0; i < len; i++) a[i] *= b[i];
+          break;
+        case CUSTOM_EXPR_DIV:
+          for (size_t i = 0; i < len; i++) a[i] /= b[i];
+          break;
+        case CUSTOM_EXPR_POW:
+          for (size_t i = 0; i < len; i++) a[i] = custom_pow_kernel(a[i], b[i]);
+          break;
+        case CUSTOM_EXPR_NEG:
+          for (size_t i = 0; i < len; i++) b[i] = -b[i];
+          break;
+        case CUSTOM_EXPR_FABS:
+          for (size_t i = 0; i < len; i++) b[i] = b[i] < 0 ? -b[i] : b[i];
+          break;
+        case CUSTOM_EXPR_EXP:
+          for (size_t i = 0; i < len; i++) b[i] = custom_exp_kernel(b[i]);
+          break;
+        case CUSTOM_EXPR_LOG:
+          for (size_t i = 0; i < len; i++) b[i] = custom_log_kernel(b[i]);
+          break;
+        case CUSTOM_EXPR_SQRT:
+          for (size_t i = 0; i < len; i++) b[i] = custom_sqrt_kernel(b[i]);
+          break;
+        case CUSTOM_EXPR_SIN:
+          for (size_t i = 0; i < len; i++) {
+            double c = 0.0;
+            custom_sincos_kernel(b[i], &b[i], &c);
+          }
+          break;
+        case CUSTOM_EXPR_COS:
+          for (size_t i = 0; i < len; i++) {
+            double s = 0.0;
+            custom_sincos_kernel(b[i], &s, &b[i]);
+          }
+          break;
+        case CUSTOM_EXPR_TAN:
+          for (size_t i = 0; i < len; i++) {
+            double s = 0.0, c = 0.0;
+            custom_sincos_kernel(b[i], &s, &c);
+            b[i] = s / c;
+          }
+          break;
+        case CUSTOM_EXPR_ATAN:
+          for (size_t i = 0; i < len; i++) b[i] = custom_atan_kernel(b[i]);
+          break;
+      }
+      if (op->code >= CUSTOM_EXPR_ADD && op->code <= CUSTOM_EXPR_POW) top--;
+    }
+    for (size_t i = 0; i < len; i++) out[start + i] = stack[0][i];
+  }
+}
+
+/*
+ * Counter-based generator: the output for a counter is two rounds of the
+ * murmur3 finaliser keyed by the two key words. Streams with different keys
+ * are statistically independent: the hash makes collisions between them
+ * unlikely, not impossible.
+ */
+static inline uint64_t custom_rng_mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  return x ^ (x >> 33);
+}
+
+static inline uint64_t custom_rng_at(const custom_rng *state, uint64_t n) {
+  uint64_t x = custom_rng_mix(n * 0x9e3779b97f4a7c15ULL ^ state->key[0]);
+  return custom_rng_mix(x ^ state->key[1]);
+}
+
+// Uniform double in the open interval (0, 1) from the top 53 bits of r.
+static inline double custom_rng_open01(uint64_t r) {
+  return ((double)(r >> 11) + 0.5) * 1.1102230246251565404e-16;  // 2^-53
+}
+
+void custom_rng_seed(custom_rng *state, uint64_t seed, uint64_t stream) {
+  state->key[0] = custom_rng_mix(seed + 0x9e3779b97f4a7c15ULL);
+  state->key[1] = custom_rng_mix(stream ^ custom_rng_mix(~seed));
+  state->counter = 0;
+}
+
+uint64_t custom_rng_next(custom_rng *state) {
+  return custom_rng_at(state, state->counter++);
+}
+
+void custom_randu_v(custom_rng *state, double *out, size_t n) {
+  uint64_t base = state->counter;
+  for (size_t i = 0; i < n; i++) {
+    out[i] = custom_rng_open01(custom_rng_at(state, base + i));
+  }
+  state->counter = base + n;
+}
+
+/*
+ * Box-Muller in tiles of CUSTOM_RNG_TILE pairs, one stage per loop so each
+ * loop is a straight run of one kernel. The angle needs no range reduction:
+ * the top two bits of the second draw pick the quadrant and the rest an
+ * angle in [-pi/4, pi/4) for custom_sin_core and custom_cos_core.
+ */
+void custom_randn_v(custom_rng *state, double *out, size_t n) {
+  double radius[CUSTOM_RNG_TILE], s[CUSTOM_RNG_TILE], c[CUSTOM_RNG_TILE];
+  size_t pairs = (n + 1) / 2;
+  uint64_t base = state->counter;
+  for (size_t start = 0; start < pairs; start += CUSTOM_RNG_TILE) {
+    size_t len = pairs - start;
+    len = len < CUSTOM_RNG_TILE ? len : CUSTOM_RNG_TILE;
+    for (size_t i = 0; i < len; i++) {
+      uint64_t r = custom_rng_at(state, base + 2 * (start + i));
+      double u = custom_rng_open01(r);
+      radius[i] = -2.0 * custom_log_core(u);
+    }
+    for (size_t i = 0; i < len; i++) radius[i] = custom_sqrt_core(radius[i]);
+    for (size_t i = 0; i < len; i++) {
+      uint64_t r = custom_rng_at(state, base + 2 * (start + i) + 1);
+      uint64_t bits = r >> 11 & 0x7ffffffffffffULL;
+      double f = (double)bits * 4.4408920985006262e-16;  // 2^-51
+      double t = (f - 0.5) * (CUSTOM_PI / 2);
+      double sr = custom_sin_core(t), cr = custom_cos_core(t);
+      int q = (int)(r >> 62);
+      double s0 = (q & 1) ? cr : sr;
+      double c0 = (q & 1) ? -sr : cr;
+      s[i] = (q & 2) ? -s0 : s0;
+      c[i] = (q & 2) ? -c0 : c0;
+    }
+    for (size_t i = 0; i < len; i++) {
+      size_t k = 2 * (start + i);
+      out[k] = radius[i] * c[i];
+      if (k + 1 < n) out[k + 1] = radius[i] * s[i];
+    }
+  }
+  state->counter = base + 2 * pairs;
+}
+
+void custom_rande_v(custom_rng *state, double *out, size_t n, double rate) {
+  double inv = rate > 0 ? 1.0 / rate : CUSTOM_NAN;
+  uint64_t base = state->counter;
+  for (size_t i = 0; i < n; i++) {
+    double u = custom_rng_open01(custom_rng_at(state, base + i));
+    out[i] = -custom_log_core(u) * inv;
+  }
+  state->counter = base + n;
+}
+
+void custom_randlogn_v(custom_rng *state, double *out, size_t n, double mu,
+                       double sigma) {
+  custom_randn_v(state, out, n);
+  for (size_t i = 0; i < n; i++) {
+    out[i] = custom_exp_kernel(mu + sigma * out[i]);
+  }
+}
+
+void custom_exp_d1(double x, double *value, double *deriv) {
+  double e = custom_exp_kernel(x);
+  *value = e;
+  *deriv = e;
+}
+
+void custom_log_d1(double x, double *value, double *deriv) {
+  *value = custom_log_kernel(x);
+  *deriv = x < 0 ? CUSTOM_NAN : 1.0 / x;
+}
+
+void custom_sin_d1(double x, double *value, double *deriv) {
+  custom_sincos_kernel(x, value, deriv);
+}
+
+void custom_cos_d1(double x, double *value, double *deriv) {
+  double s = 0.0;
+  custom_sincos_kernel(x, &s, value);
+  *deriv = -s;
+}
+
+void custom_atan_d1(double x, double *value, double *deriv) {
+  *value = custom_atan_kernel(x);
+  *deriv = 1.0 / (1.0 + x * x);
+}
+
+void custom_sqrt_d1(double x, double *value, double *deriv) {
+  double r = custom_sqrt_kernel(x);
+  *value = r;
+  *deriv = 0.5 / r;
+}
+
+/*
+ * d/dx x^y = y x^y / x reuses the value, only x = 0 needs y x^(y - 1) from a
+ * second exponential, and y = 0 selects 0 where that would be 0 * inf.
+ * d/dy x^y = x^y ln(x) reuses the logarithm.
+ */
+void custom_pow_d1(double x, double y, double *value, double *dx,
+                   double *dy) {
+  double log_ax = custom_log_kernel(x < 0 ? -x : x);
+  double v = custom_pow_from_log(x, y, log_ax);
+  *value = v;
+  *dx = x != 0 ? y * v / x : y * custom_pow_from_log(x, y - 1.0, log_ax);
+  *dx = y == 0 ? 0.0 : *dx;
+  *dy = x < 0 ? CUSTOM_NAN : (v == 0 ? 0.0 : v * log_ax);
+}
+
+void custom_exp_d1_array(const double *x, double *value, double *deriv,
+                         size_t n) {
+  for (size_t i = 0; i < n; i++) custom_exp_d1(x[i], &value[i], &deriv[i]);
+}
+
+void custom_log_d1_array(const double *x, double *value, double *deriv,
+                         size_t n) {
+  for (size_t i = 0; i < n; i++) custom_log_d1(x[i], &value[i], &deriv[i]);
+}
+
+void custom_sin_d1_array(const double *x, double *value, double *deriv,
+                         size_t n) {
+  for (size_t i = 0; i < n; i++) custom_sin_d1(x[i], &value[i], &deriv[i]);
+}
+
+void custom_cos_d1_array(const double *x, double *value, double *deriv,
+                         size_t n) {
+  for (size_t i = 0; i < n; i++) custom_cos_d1(x[i], &value[i], &deriv[i]);
+}
+
+void custom_atan_d1_array(const double *x, double *value, double *deriv,
+                          size_t n) {
+  for (size_t i = 0; i < n; i++) custom_atan_d1(x[i], &value[i], &deriv[i]);
+}
+
+void custom_sqrt_d1_array(const double *x, double *value, double *deriv,
+                          size_t n) {
+  for (size_t i = 0; i < n; i++) custom_sqrt_d1(x[i], &value[i], &deriv[i]);
+}
+
+void custom_pow_d1_array(const double *x, const double *y, double *value,
+                         double *dx, double *dy, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    custom_pow_d1(x[i], y[i], &value[i], &dx[i], &dy[i]);
+  }
+}
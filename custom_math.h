@@ -1,3 +1,8 @@
+#ifndef CUSTOM_MATH_H
+#define CUSTOM_MATH_H
+
+#include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
 
 // Mathematical constants
@@ -11,10 +16,79 @@
 #define CUSTOM_INF_NEG (-1.0 / 0.0)
 #define CUSTOM_TRG_PRC 1e-6L  // accuracy of trigonometric functions
 #define CUSTOM_PRC 1e-16      // test accuracy
+#define CUSTOM_EXP_MIN_ARG -708.0  // exp kernel flushes smaller arguments to 0
+#define CUSTOM_EXP_MAX_ARG 709.782712893384  // ln(DBL_MAX), inf above
+#define CUSTOM_TRG_MAX_ARG 1073741824.0  // 2^30, range of the sincos kernel
+#define CUSTOM_FACTORIAL_MAX 1754  // largest factorial a long double holds
+#define CUSTOM_EXPR_MAX_OPS 64     // instructions in one fused expression
+#define CUSTOM_EXPR_MAX_DEPTH 8    // values live at once while evaluating
+#define CUSTOM_EXPR_MAX_INPUTS 8   // input arrays of one fused expression
+#define CUSTOM_EXPR_TILE 256       // elements per tile, 8 * 256 doubles = 16 KB
+#define CUSTOM_RNG_TILE 64         // normal pairs generated per tile
+#define CUSTOM_PI_4_MAX 0.7854     // pi/4 rounded up, domain of the reduced trig kernels
+#define CUSTOM_TAN_PI_8_MAX 0.4143  // tan(pi/8) rounded up, domain of custom_atan_reduced
+// Splits of ln(2) used by the exponential and logarithm kernels
+#define CUSTOM_LN2_HI 6.93147180369123816490e-01
+#define CUSTOM_LN2_LO 1.90821492927058770002e-10
+#define CUSTOM_SQRT2 1.41421356237309504880
+#define CUSTOM_EXP_MINUS_HALF 0.60653065971263342360  // e^-0.5
+#define CUSTOM_DBL_MIN 2.2250738585072014e-308  // smallest normal double
+// Bit patterns of |x| used by the classification functions
+#define CUSTOM_DBL_ABS_MASK 0x7fffffffffffffffULL
+#define CUSTOM_DBL_INF_BITS 0x7ff0000000000000ULL   // +infinity
+#define CUSTOM_DBL_ONE_BITS 0x3ff0000000000000ULL   // 1.0
+#define CUSTOM_DBL_MIN_BITS 0x0010000000000000ULL   // CUSTOM_DBL_MIN
 
 // Check NaN value
 #define CUSTOM_IS_NAN(X) (X != X)
 
+// Instructions of a fused expression, see custom_expr_build
+typedef enum {
+  CUSTOM_EXPR_INPUT,  // push element i of input array `input`
+  CUSTOM_EXPR_CONST,  // push `value`
+  CUSTOM_EXPR_ADD,    // pop b, pop a, push a + b
+  CUSTOM_EXPR_SUB,    // pop b, pop a, push a - b
+  CUSTOM_EXPR_MUL,    // pop b, pop a, push a * b
+  CUSTOM_EXPR_DIV,    // pop b, pop a, push a / b
+  CUSTOM_EXPR_POW,    // pop b, pop a, push a^b
+  CUSTOM_EXPR_NEG,    // replace a by -a
+  CUSTOM_EXPR_FABS,   // replace a by |a|
+  CUSTOM_EXPR_EXP,    // replace a by e^a
+  CUSTOM_EXPR_LOG,    // replace a by ln(a)
+  CUSTOM_EXPR_SQRT,   // replace a by sqrt(a)
+  CUSTOM_EXPR_SIN,    // replace a by sin(a)
+  CUSTOM_EXPR_COS,    // replace a by cos(a)
+  CUSTOM_EXPR_TAN,    // replace a by tan(a)
+  CUSTOM_EXPR_ATAN    // replace a by atan(a)
+} custom_expr_code;
+
+typedef struct {
+  custom_expr_code code;
+  int input;     // input array index for CUSTOM_EXPR_INPUT
+  double value;  // constant for CUSTOM_EXPR_CONST
+} custom_expr_op;
+
+/*
+ * State of the counter-based random generator, see custom_rng_seed. Draw i
+ * of a stream is a pure function of the key and counter i, so the counter
+ * may be set directly to jump ahead.
+ */
+typedef struct {
+  uint64_t key[2];
+  uint64_t counter;
+} custom_rng;
+
+// Bit access to a double, used by the kernels working on the exponent field
+typedef union {
+  uint64_t u;
+  double d;
+} custom_dbl_bits;
+
+typedef struct {
+  custom_expr_op ops[CUSTOM_EXPR_MAX_OPS];
+  size_t n_ops;
+} custom_expr;
+
 /**
  * @brief Returns the absolute value of an integer number.
  *
@@ -46,12 +120,42 @@ long double custom_fabsl(long double x);
  * @brief Calculates the factorial of a non-negative integer x.
  *
  * The custom_factorial function computes the product of all positive integers up
- * to x. If x is less than 0, the function returns NaN.
+ * to x. If x is less than 0, the function returns NaN. Factorials up to 25!
+ * come exactly from a table, larger ones from custom_tgamma(x + 1), so every
+ * call runs in constant time.
  *
  * @param x The value to calculate the factorial of.
- * @return The factorial of x, or NaN if x is negative.
+ * @return The factorial of x, or NaN if x is negative. Positive infinity for
+ * x above CUSTOM_FACTORIAL_MAX.
  */
 long double custom_factorial(int x);
+/**
+ * @brief Calculates the gamma function of x.
+ *
+ * Arguments of at least 16 use the Stirling series in long double, smaller
+ * positive ones are shifted up to 16 with gamma(x + 1) = x gamma(x) and
+ * negative ones use the reflection gamma(x) gamma(1 - x) = π / sin(πx).
+ * Integer arguments up to 26 come exactly from the factorial table.
+ *
+ * @param x The argument.
+ * @return Γ(x), within about 3e-18 relative for |x| below 30, growing with
+ * log|Γ(x)| to 2e-15 near the long double overflow threshold. Returns positive infinity
+ * above about 1755.5, NaN for negative integers and negative infinity, and
+ * ±infinity for ±0.
+ */
+long double custom_tgamma(double x);
+/**
+ * @brief Calculates the natural logarithm of the absolute value of gamma(x).
+ *
+ * Uses the same Stirling series, shift and reflection as custom_tgamma
+ * without leaving log space, so arguments up to the largest double do not
+ * overflow. custom_lgamma(n + 1) is log(n!).
+ *
+ * @param x The argument.
+ * @return log|Γ(x)|, within about 1e-17 absolute near its zeros at 1 and 2.
+ * Returns positive infinity for non-positive integers and infinite `x`.
+ */
+long double custom_lgamma(double x);
 /**
  * @brief Calculates the largest integer value less than or equal to x.
  *
@@ -230,4 +334,692 @@ long double custom_sqrt(double x);
  * tangent, which is undefined at odd multiples of π/2.
  */
 long double custom_tan(double x);
-int custom_trg_norm(long double *phi);
\ No newline at end of file
+/**
+ * @brief Calculates log(exp(x[0]) + ... + exp(x[n - 1])) without overflow.
+ *
+ * The function finds the maximum m of the array in a first pass and then sums
+ * exp(x[i] - m) with a branch-free exponential kernel and Kahan compensated
+ * summation in a second pass. The result is m + log(sum), so arguments far
+ * beyond the range of custom_exp (e.g. 1000.0) are handled exactly.
+ *
+ * @param x The input array.
+ * @param n The number of elements in `x`.
+ * @return The log-sum-exp of `x`. Returns negative infinity for an empty
+ * array or when every element is negative infinity, positive infinity when
+ * any element is positive infinity and NaN when any element is NaN.
+ */
+long double custom_logsumexp(const double *x, size_t n);
+/**
+ * @brief Calculates the softmax of an array.
+ *
+ * The function writes exp(x[i] - m) / sum(exp(x[j] - m)) to `out`, where m is
+ * the maximum of `x`. The exponentials are stored during the summation pass,
+ * so only one exponential is evaluated per element. `out` may alias `x`.
+ *
+ * @param x The input array.
+ * @param out The output array of `n` elements.
+ * @param n The number of elements in `x` and `out`.
+ *
+ * @note If any element is NaN the whole output is NaN. Elements equal to
+ * positive infinity share the probability mass equally, and an array of only
+ * negative infinities yields the uniform distribution.
+ */
+void custom_softmax(const double *x, double *out, size_t n);
+/**
+ * @brief Calculates the complex exponential of z.
+ *
+ * For z = a + bi the result is e^a * (cos(b) + i sin(b)). The sine and cosine
+ * of b come from a single range reduction and e^a from the same branch-free
+ * kernel as custom_logsumexp.
+ *
+ * @param z The complex exponent.
+ * @return The complex exponential of `z`. A zero imaginary part is kept as is,
+ * so real arguments give real results.
+ *
+ * @note The imaginary part must satisfy |b| < CUSTOM_TRG_MAX_ARG, outside of
+ * that range (and for infinite b) the result is NaN.
+ */
+double _Complex custom_cexp(double _Complex z);
+/**
+ * @brief Calculates the principal natural logarithm of z.
+ *
+ * The real part is log|z|, computed as log(m) + log(1 + q^2) / 2 with m the
+ * larger and q the ratio of the two components so that |z| never overflows.
+ * The imaginary part is the argument of z in [-π, π].
+ *
+ * @param z The complex argument.
+ * @return The principal logarithm of `z`. For z equal to 0 the real part is
+ * negative infinity.
+ */
+double _Complex custom_clog(double _Complex z);
+/**
+ * @brief Raises a complex base to a complex exponent.
+ *
+ * The result is custom_cexp(w * custom_clog(z)), evaluated on split real and
+ * imaginary parts without intermediate complex values.
+ *
+ * @param z The base.
+ * @param w The exponent.
+ * @return `z` raised to `w`. For z equal to 0 the result is 1 if w is 0, 0 if
+ * the real part of w is positive and NaN otherwise.
+ */
+double _Complex custom_cpow(double _Complex z, double _Complex w);
+/**
+ * @brief Calculates the complex sine of z.
+ *
+ * For z = a + bi the result is sin(a) cosh(b) + i cos(a) sinh(b). Sine and
+ * cosine share one range reduction, cosh and sinh share one exponential.
+ *
+ * @param z The complex angle.
+ * @return The complex sine of `z`.
+ *
+ * @note The real part must satisfy |a| < CUSTOM_TRG_MAX_ARG.
+ */
+double _Complex custom_csin(double _Complex z);
+/**
+ * @brief Calculates the complex cosine of z.
+ *
+ * For z = a + bi the result is cos(a) cosh(b) - i sin(a) sinh(b). Sine and
+ * cosine share one range reduction, cosh and sinh share one exponential.
+ *
+ * @param z The complex angle.
+ * @return The complex cosine of `z`.
+ *
+ * @note The real part must satisfy |a| < CUSTOM_TRG_MAX_ARG.
+ */
+double _Complex custom_ccos(double _Complex z);
+/**
+ * @brief Calculates the principal square root of z.
+ *
+ * The result has a non-negative real part and an imaginary part with the sign
+ * of the imaginary part of z. |z| is computed without overflow.
+ *
+ * @param z The complex argument.
+ * @return The principal square root of `z`. An infinite imaginary part gives
+ * positive infinity plus the same infinite imaginary part.
+ */
+double _Complex custom_csqrt(double _Complex z);
+/**
+ * @brief Array forms of the complex functions.
+ *
+ * The `_array` variants work on interleaved arrays of `double _Complex`
+ * (`double complex` with <complex.h>), the `_split` variants on separate
+ * arrays of real and imaginary parts. Each
+ * element i of the output is the scalar function applied to element i of the
+ * input, and the outputs may alias the inputs.
+ *
+ * @param z, re, im The input values.
+ * @param w, w_re, w_im The exponents of the custom_cpow variants.
+ * @param out, out_re, out_im The output arrays.
+ * @param n The number of elements.
+ */
+void custom_cexp_array(const double _Complex *z, double _Complex *out,
+                       size_t n);
+void custom_cexp_split(const double *re, const double *im, double *out_re,
+                       double *out_im, size_t n);
+void custom_clog_array(const double _Complex *z, double _Complex *out,
+                       size_t n);
+void custom_clog_split(const double *re, const double *im, double *out_re,
+                       double *out_im, size_t n);
+void custom_cpow_array(const double _Complex *z, const double _Complex *w,
+                       double _Complex *out, size_t n);
+void custom_cpow_split(const double *re, const double *im, const double *w_re,
+                       const double *w_im, double *out_re, double *out_im,
+                       size_t n);
+void custom_csin_array(const double _Complex *z, double _Complex *out,
+                       size_t n);
+void custom_csin_split(const double *re, const double *im, double *out_re,
+                       double *out_im, size_t n);
+void custom_ccos_array(const double _Complex *z, double _Complex *out,
+                       size_t n);
+void custom_ccos_split(const double *re, const double *im, double *out_re,
+                       double *out_im, size_t n);
+void custom_csqrt_array(const double _Complex *z, double _Complex *out,
+                        size_t n);
+void custom_csqrt_split(const double *re, const double *im, double *out_re,
+                        double *out_im, size_t n);
+/*
+ * Fixed-point functions. The _q16 family works on Q16.16 values (int32_t
+ * holding x * 2^16), angles are radians. The _q31 family works on Q1.31
+ * values (int32_t holding x * 2^31, range [-1, 1)), angles are fractions of
+ * π so that the full int32_t range covers one turn. Only integer arithmetic
+ * is used, every call runs a fixed number of steps, and results that do not
+ * fit the format saturate to INT32_MAX or INT32_MIN. Invalid arguments
+ * (negative for sqrt, non-positive for log) return INT32_MIN.
+ */
+/**
+ * @brief Calculates the sine of a Q16.16 angle in radians.
+ *
+ * The angle is reduced to [-π/4, π/4] against a Q.46 constant for π/2 and
+ * rotated with 30 CORDIC iterations in Q2.30.
+ *
+ * @param x The angle in radians, Q16.16.
+ * @return The sine of `x` in Q16.16, within 1 LSB (2^-16) of the exact value.
+ */
+int32_t custom_sin_q16(int32_t x);
+/**
+ * @brief Calculates the cosine of a Q16.16 angle in radians.
+ *
+ * Uses the same reduction and CORDIC rotation as custom_sin_q16.
+ *
+ * @param x The angle in radians, Q16.16.
+ * @return The cosine of `x` in Q16.16, within 1 LSB (2^-16) of the exact
+ * value.
+ */
+int32_t custom_cos_q16(int32_t x);
+/**
+ * @brief Calculates the square root of a Q16.16 value.
+ *
+ * The result is the rounded integer square root of x * 2^16.
+ *
+ * @param x The value, Q16.16.
+ * @return The square root of `x` in Q16.16, within 0.5 LSB of the exact
+ * value, or INT32_MIN for negative `x`.
+ */
+int32_t custom_sqrt_q16(int32_t x);
+/**
+ * @brief Calculates e raised to a Q16.16 power.
+ *
+ * x * log2(e) is split into an integer n and a fraction f, 2^f is evaluated
+ * with an integer polynomial in Q2.30 and shifted by n.
+ *
+ * @param x The exponent, Q16.16.
+ * @return e^x in Q16.16, within 1 LSB plus 2^-26 relative of the exact value.
+ * Saturates to INT32_MAX for x above ln(32768) ≈ 10.4.
+ */
+int32_t custom_exp_q16(int32_t x);
+/**
+ * @brief Calculates the natural logarithm of a Q16.16 value.
+ *
+ * x is normalised by its highest set bit and the logarithm of the mantissa
+ * is taken from the atanh series in Q2.30.
+ *
+ * @param x The value, Q16.16.
+ * @return The natural logarithm of `x` in Q16.16, within 1 LSB of the exact
+ * value, or INT32_MIN for non-positive `x`.
+ */
+int32_t custom_log_q16(int32_t x);
+/**
+ * @brief Calculates the angle of the point (x, y).
+ *
+ * The vector is normalised and rotated onto the positive x axis with 30
+ * CORDIC iterations. `x` and `y` may use any common fixed-point format.
+ *
+ * @param y The y coordinate.
+ * @param x The x coordinate.
+ * @return atan2(y, x) in radians, Q16.16, within 1 LSB of the exact value.
+ * The angle of (0, 0) is 0.
+ */
+int32_t custom_atan2_q16(int32_t y, int32_t x);
+/**
+ * @brief Q1.31 variants of the fixed-point functions.
+ *
+ * custom_sin_q31 and custom_cos_q31 take an angle in units of π, so 2^30 is
+ * π/2 and INT32_MIN is -π. custom_atan2_q31 returns an angle in the same
+ * units. custom_exp_q31 saturates for non-negative arguments and
+ * custom_log_q31 for arguments below 1/e, whose results are outside
+ * [-1, 1). All results are within 2^-26 of the exact value.
+ *
+ * @param x, y The arguments, Q1.31.
+ * @return The result, Q1.31.
+ */
+int32_t custom_sin_q31(int32_t x);
+int32_t custom_cos_q31(int32_t x);
+int32_t custom_sqrt_q31(int32_t x);
+int32_t custom_exp_q31(int32_t x);
+int32_t custom_log_q31(int32_t x);
+int32_t custom_atan2_q31(int32_t y, int32_t x);
+/**
+ * @brief Array forms of the fixed-point functions.
+ *
+ * Element i of `out` is the scalar function applied to element i of the
+ * inputs. The loops have no data-dependent branches and may run in place.
+ *
+ * @param x, y The input arrays.
+ * @param out The output array.
+ * @param n The number of elements.
+ */
+void custom_sin_q16_array(const int32_t *x, int32_t *out, size_t n);
+void custom_cos_q16_array(const int32_t *x, int32_t *out, size_t n);
+void custom_sqrt_q16_array(const int32_t *x, int32_t *out, size_t n);
+void custom_exp_q16_array(const int32_t *x, int32_t *out, size_t n);
+void custom_log_q16_array(const int32_t *x, int32_t *out, size_t n);
+void custom_atan2_q16_array(const int32_t *y, const int32_t *x, int32_t *out,
+                            size_t n);
+void custom_sin_q31_array(const int32_t *x, int32_t *out, size_t n);
+void custom_cos_q31_array(const int32_t *x, int32_t *out, size_t n);
+void custom_sqrt_q31_array(const int32_t *x, int32_t *out, size_t n);
+void custom_exp_q31_array(const int32_t *x, int32_t *out, size_t n);
+void custom_log_q31_array(const int32_t *x, int32_t *out, size_t n);
+void custom_atan2_q31_array(const int32_t *y, const int32_t *x, int32_t *out,
+                            size_t n);
+/**
+ * @brief Compiles a chain of operations into a fused expression.
+ *
+ * The operations form a postfix program over a value stack: inputs and
+ * constants push a value, unary operations replace the top value and binary
+ * operations combine the two top values. For example
+ * custom_exp(-custom_pow(x, 2)) * custom_cos(y) is
+ * INPUT 0, CONST 2, POW, NEG, EXP, INPUT 1, COS, MUL.
+ *
+ * @param expr The expression to fill.
+ * @param ops The operations in postfix order.
+ * @param n_ops The number of operations.
+ * @return 0 on success, 1 if the program is empty or longer than
+ * CUSTOM_EXPR_MAX_OPS, uses an unknown code or an input index outside
+ * [0, CUSTOM_EXPR_MAX_INPUTS), needs more than CUSTOM_EXPR_MAX_DEPTH stack
+ * values, pops an empty stack or does not end with exactly one value.
+ */
+int custom_expr_build(custom_expr *expr, const custom_expr_op *ops,
+                      size_t n_ops);
+/**
+ * @brief Evaluates a fused expression over arrays.
+ *
+ * The arrays are processed in tiles of CUSTOM_EXPR_TILE elements. Within a
+ * tile every operation runs as one tight loop over stack buffers that stay in
+ * L1 cache, so the whole chain costs a single pass over the inputs and the
+ * output instead of one pass per function. The operations use the same
+ * branch-free double kernels as the complex and array functions.
+ *
+ * @param expr An expression built with custom_expr_build.
+ * @param inputs The input arrays, indexed by the `input` field of the
+ * CUSTOM_EXPR_INPUT operations.
+ * @param out The output array, which may alias one of the inputs.
+ * @param n The number of elements.
+ *
+ * @note Sine, cosine and tangent arguments must satisfy
+ * |x| < CUSTOM_TRG_MAX_ARG, outside of that range they give NaN.
+ */
+void custom_expr_eval(const custom_expr *expr, const double *const *inputs,
+                      double *out, size_t n);
+/**
+ * @brief Switches deterministic, bounded-latency mode on or off.
+ *
+ * In deterministic mode every function runs a fixed number of operations
+ * that does not depend on its argument, so the worst-case latency equals the
+ * typical one. The trigonometric, exponential, logarithmic and root
+ * functions use the branch-free double kernels instead of their iterative
+ * series:
+ * - custom_sin, custom_cos, custom_tan: one four-part π/2 reduction and
+ *   polynomials of 8 and 9 terms.
+ * - custom_exp: one ln(2) reduction and a 15 term polynomial.
+ * - custom_log: one bit-level normalisation and an 11 term series.
+ * - custom_sqrt: a bit-level initial guess and 4 Newton steps.
+ * - custom_atan: up to two reciprocal reductions and a 23 term series.
+ * - custom_asin, custom_acos: one custom_sqrt and one custom_atan step.
+ * - custom_pow: 10 squaring steps in double, used for integer exponents
+ *   below 1024 in magnitude, and one exponential and logarithm kernel for
+ *   all other exponents. Both paths always run and the result is selected.
+ * - custom_factorial: one Stirling series and exponential, also for the
+ *   table entries up to 25!.
+ * The remaining functions already run in constant time. Results are then
+ * accurate to double precision rather than long double, and sine, cosine and
+ * tangent of arguments beyond CUSTOM_TRG_MAX_ARG are NaN.
+ *
+ * The mode is process-wide and is meant to be set once at startup. Building
+ * with CUSTOM_MATH_DETERMINISTIC defined makes it the default.
+ *
+ * @param enabled Non-zero to enable deterministic mode, 0 to disable it.
+ */
+void custom_set_deterministic(int enabled);
+/**
+ * @brief Reports whether deterministic mode is enabled.
+ *
+ * @return 1 if deterministic mode is enabled, 0 otherwise.
+ */
+int custom_is_deterministic(void);
+/**
+ * @brief Seeds a counter-based random stream.
+ *
+ * The key is derived from both `seed` and `stream` and the counter starts at
+ * 0. Different streams of one seed are independent, so giving each thread
+ * its own stream number makes a parallel run reproducible regardless of
+ * scheduling.
+ *
+ * @param state The generator state to initialise.
+ * @param seed The seed shared by all streams of a run.
+ * @param stream The stream number, e.g. the thread index.
+ */
+void custom_rng_seed(custom_rng *state, uint64_t seed, uint64_t stream);
+/**
+ * @brief Returns the next 64 random bits of a stream.
+ *
+ * @param state The generator state, its counter advances by 1.
+ * @return Uniformly distributed 64-bit value.
+ */
+uint64_t custom_rng_next(custom_rng *state);
+/**
+ * @brief Fills an array with uniform samples from (0, 1).
+ *
+ * @param state The generator state, its counter advances by `n`.
+ * @param out The output array of `n` elements.
+ * @param n The number of samples.
+ */
+void custom_randu_v(custom_rng *state, double *out, size_t n);
+/**
+ * @brief Fills an array with standard normal samples.
+ *
+ * Uses the Box-Muller transform in tiles of CUSTOM_RNG_TILE pairs. The
+ * radius sqrt(-2 log u) runs through custom_log_finite and
+ * custom_sqrt_finite, and the angle is drawn directly as a quadrant plus an
+ * offset in [-π/4, π/4), so one custom_sin_reduced and one
+ * custom_cos_reduced give both samples of a pair without range reduction.
+ *
+ * @param state The generator state, its counter advances by 2 per pair,
+ * i.e. by `n` rounded up to even.
+ * @param out The output array of `n` elements.
+ * @param n The number of samples.
+ */
+void custom_randn_v(custom_rng *state, double *out, size_t n);
+/**
+ * @brief Fills an array with exponential samples.
+ *
+ * Each sample is -log(u) / rate for u uniform in (0, 1), so it is positive
+ * and finite for any rate > 0 whose reciprocal does not overflow.
+ *
+ * @param state The generator state, its counter advances by `n`.
+ * @param out The output array of `n` elements.
+ * @param n The number of samples.
+ * @param rate The rate λ > 0 of the distribution, its mean is 1 / λ. Rates
+ * that are not positive, including NaN, give NaN samples.
+ */
+void custom_rande_v(custom_rng *state, double *out, size_t n, double rate);
+/**
+ * @brief Fills an array with log-normal samples.
+ *
+ * Each sample is exp(mu + sigma * z) for z from custom_randn_v, computed with
+ * the branch-free exponential kernel.
+ *
+ * @param state The generator state, its counter advances as for
+ * custom_randn_v.
+ * @param out The output array of `n` elements.
+ * @param n The number of samples.
+ * @param mu The mean of the underlying normal distribution.
+ * @param sigma The standard deviation of the underlying normal distribution.
+ */
+void custom_randlogn_v(custom_rng *state, double *out, size_t n, double mu,
+                       double sigma);
+/**
+ * @brief Calculates a function and its derivative in one call.
+ *
+ * Each variant writes f(x) to `value` and f'(x) to `deriv`, taking the
+ * derivative from the intermediate state of the value instead of a second
+ * evaluation: custom_exp_d1 reuses e^x, custom_sin_d1 and custom_cos_d1 the
+ * sine and cosine of one range reduction, custom_sqrt_d1 computes
+ * 1 / (2 sqrt(x)) from the root, custom_log_d1 and custom_atan_d1 only add
+ * one division. Values come from the branch-free double kernels, so special
+ * arguments give the same results as in deterministic mode.
+ *
+ * @param x The argument.
+ * @param value Receives f(x).
+ * @param deriv Receives f'(x).
+ */
+void custom_exp_d1(double x, double *value, double *deriv);
+void custom_log_d1(double x, double *value, double *deriv);
+void custom_sin_d1(double x, double *value, double *deriv);
+void custom_cos_d1(double x, double *value, double *deriv);
+void custom_atan_d1(double x, double *value, double *deriv);
+void custom_sqrt_d1(double x, double *value, double *deriv);
+/**
+ * @brief Calculates x^y and its partial derivatives in one call.
+ *
+ * ln|x| is computed once and shared by the value and d/dy = x^y ln(x), and
+ * d/dx = y x^y / x reuses the value. Only x = 0 takes a second exponential
+ * for y x^(y - 1).
+ *
+ * @param x The base.
+ * @param y The exponent.
+ * @param value Receives x^y.
+ * @param dx Receives the derivative with respect to x.
+ * @param dy Receives the derivative with respect to y, NaN for negative x.
+ */
+void custom_pow_d1(double x, double y, double *value, double *dx,
+                   double *dy);
+/**
+ * @brief Array forms of the derivative functions.
+ *
+ * Element i of each output is the scalar variant applied to element i of
+ * the inputs. The outputs may alias the inputs.
+ *
+ * @param x, y The input arrays.
+ * @param value, deriv, dx, dy The output arrays.
+ * @param n The number of elements.
+ */
+void custom_exp_d1_array(const double *x, double *value, double *deriv,
+                         size_t n);
+void custom_log_d1_array(const double *x, double *value, double *deriv,
+                         size_t n);
+void custom_sin_d1_array(const double *x, double *value, double *deriv,
+                         size_t n);
+void custom_cos_d1_array(const double *x, double *value, double *deriv,
+                         size_t n);
+void custom_atan_d1_array(const double *x, double *value, double *deriv,
+                          size_t n);
+void custom_sqrt_d1_array(const double *x, double *value, double *deriv,
+                          size_t n);
+void custom_pow_d1_array(const double *x, const double *y, double *value,
+                         double *dx, double *dy, size_t n);
+/*
+ * Classification. Each test is a single integer comparison on the bit
+ * pattern of x, so it has no floating-point compare, does not raise
+ * exceptions on NaN and vectorises in array loops.
+ */
+/**
+ * @brief Returns the bit pattern of |x|.
+ *
+ * @param x The value.
+ * @return The IEEE 754 bits of `x` with the sign bit cleared.
+ */
+static inline uint64_t custom_abs_bits(double x) {
+  custom_dbl_bits b = {0};
+  b.d = x;
+  return b.u & CUSTOM_DBL_ABS_MASK;
+}
+/**
+ * @brief Checks whether x is NaN.
+ *
+ * @param x The value.
+ * @return 1 if `x` is NaN, 0 otherwise.
+ */
+static inline int custom_isnan(double x) {
+  return custom_abs_bits(x) > CUSTOM_DBL_INF_BITS;
+}
+/**
+ * @brief Checks whether x is positive or negative infinity.
+ *
+ * @param x The value.
+ * @return 1 if `x` is infinite, 0 otherwise.
+ */
+static inline int custom_isinf(double x) {
+  return custom_abs_bits(x) == CUSTOM_DBL_INF_BITS;
+}
+/**
+ * @brief Checks whether x is finite, i.e. neither infinite nor NaN.
+ *
+ * @param x The value.
+ * @return 1 if `x` is finite, 0 otherwise.
+ */
+static inline int custom_isfinite(double x) {
+  return custom_abs_bits(x) < CUSTOM_DBL_INF_BITS;
+}
+/**
+ * @brief Checks the sign bit of x.
+ *
+ * Unlike x < 0 this also reports the sign of -0.0 and of NaN.
+ *
+ * @param x The value.
+ * @return 1 if the sign bit of `x` is set, 0 otherwise.
+ */
+static inline int custom_signbit(double x) {
+  custom_dbl_bits b = {0};
+  b.d = x;
+  return (int)(b.u >> 63);
+}
+/*
+ * Polynomial cores of the unchecked kernels below, without the domain
+ * assert. The library's own branch-free kernels call these directly, so
+ * their cost is the same whether or not NDEBUG is defined.
+ */
+static inline double custom_sin_core(double x) {
+  static const double coef[] = {
+      -1.0 / 6.0,           1.0 / 120.0,          -1.0 / 5040.0,
+      1.0 / 362880.0,       -1.0 / 39916800.0,    1.0 / 6227020800.0,
+      -1.0 / 1307674368000, 1.0 / 355687428096000};
+  double z = x * x;
+  double p = coef[7];
+  for (int i = 6; i >= 0; i--) p = p * z + coef[i];
+  return x + x * z * p;
+}
+static inline double custom_cos_core(double x) {
+  static const double coef[] = {
+      -1.0 / 2.0,          1.0 / 24.0,            -1.0 / 720.0,
+      1.0 / 40320.0,       -1.0 / 3628800.0,      1.0 / 479001600.0,
+      -1.0 / 87178291200., 1.0 / 20922789888000., -1.0 / 6402373705728000.};
+  double z = x * x;
+  double p = coef[8];
+  for (int i = 7; i >= 0; i--) p = p * z + coef[i];
+  return 1.0 + z * p;
+}
+static inline double custom_exp_core(double x) {
+  double p = 1.0 / 87178291200.0;
+  p = p * x + 1.0 / 6227020800.0;
+  p = p * x + 1.0 / 479001600.0;
+  p = p * x + 1.0 / 39916800.0;
+  p = p * x + 1.0 / 3628800.0;
+  p = p * x + 1.0 / 362880.0;
+  p = p * x + 1.0 / 40320.0;
+  p = p * x + 1.0 / 5040.0;
+  p = p * x + 1.0 / 720.0;
+  p = p * x + 1.0 / 120.0;
+  p = p * x + 1.0 / 24.0;
+  p = p * x + 1.0 / 6.0;
+  p = p * x + 0.5;
+  p = p * x + 1.0;
+  return p * x + 1.0;
+}
+static inline double custom_log_core(double x) {
+  custom_dbl_bits b = {0};
+  b.d = x;
+  int64_t e = (int64_t)((b.u >> 52) & 0x7ff) - 1023;
+  b.u = (b.u & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+  int shift = b.d > CUSTOM_SQRT2;
+  double m = shift ? b.d * 0.5 : b.d;
+  e += shift;
+  double s = (m - 1.0) / (m + 1.0);
+  double z = s * s;
+  double p = 1.0 / 21.0;
+  for (int i = 19; i >= 1; i -= 2) p = p * z + 1.0 / i;
+  return (double)e * CUSTOM_LN2_HI + (2.0 * s * p + (double)e * CUSTOM_LN2_LO);
+}
+static inline double custom_sqrt_core(double x) {
+  custom_dbl_bits b = {0};
+  b.d = x;
+  b.u = (b.u >> 1) + 0x1ff8000000000000ULL;
+  double g = b.d;
+  for (int i = 0; i < 4; i++) g = 0.5 * (g + x / g);
+  return g;
+}
+static inline double custom_atan_core(double x) {
+  double z = x * x;
+  double p = 1.0 / 45.0;
+  for (int i = 43; i >= 1; i -= 2) p = p * -z + 1.0 / i;
+  return x * p;
+}
+/*
+ * Unchecked kernels. These expose the polynomial cores behind the branch-free
+ * double kernels to callers that already know their argument lies in a
+ * small finite range. They do no NaN, infinity or sign handling and no range
+ * reduction, so they inline into hot loops as a plain sequence of multiply
+ * and add steps. The domain is checked with assert, which costs nothing when
+ * NDEBUG is defined; outside of it the results are unspecified.
+ */
+/**
+ * @brief Calculates the sine of an angle in [-π/4, π/4].
+ *
+ * Evaluates the Taylor polynomial of degree 17 directly on `x`.
+ *
+ * @param x The angle in radians, |x| <= π/4.
+ * @return The sine of `x`, accurate to double precision.
+ */
+static inline double custom_sin_reduced(double x) {
+  assert(x >= -CUSTOM_PI_4_MAX && x <= CUSTOM_PI_4_MAX);
+  return custom_sin_core(x);
+}
+/**
+ * @brief Calculates the cosine of an angle in [-π/4, π/4].
+ *
+ * Evaluates the Taylor polynomial of degree 18 directly on `x`.
+ *
+ * @param x The angle in radians, |x| <= π/4.
+ * @return The cosine of `x`, accurate to double precision.
+ */
+static inline double custom_cos_reduced(double x) {
+  assert(x >= -CUSTOM_PI_4_MAX && x <= CUSTOM_PI_4_MAX);
+  return custom_cos_core(x);
+}
+/**
+ * @brief Calculates e raised to a power in [-0.5, 0.5].
+ *
+ * Evaluates the Taylor polynomial of degree 14 directly on `x`.
+ *
+ * @param x The exponent, |x| <= 0.5.
+ * @return e^x, accurate to double precision.
+ */
+static inline double custom_exp_reduced(double x) {
+  assert(x >= -0.5 && x <= 0.5);
+  return custom_exp_core(x);
+}
+/**
+ * @brief Calculates e raised to a power in [-1, 0].
+ *
+ * Shifts `x` by 0.5 into the domain of custom_exp_reduced and scales the
+ * result by e^-0.5.
+ *
+ * @param x The exponent, -1 <= x <= 0, e.g. a max-shifted softmax argument.
+ * @return e^x, accurate to double precision.
+ */
+static inline double custom_exp_small(double x) {
+  assert(x >= -1.0 && x <= 0.0);
+  return CUSTOM_EXP_MINUS_HALF * custom_exp_core(x + 0.5);
+}
+/**
+ * @brief Calculates the natural logarithm of a positive, finite, normal x.
+ *
+ * x is split into 2^e * m with m in [sqrt(2)/2, sqrt(2)) from its bits and
+ * log(m) is evaluated with the atanh series in s = (m - 1) / (m + 1).
+ *
+ * @param x The argument, CUSTOM_DBL_MIN <= x < infinity.
+ * @return The natural logarithm of `x`, accurate to double precision.
+ */
+static inline double custom_log_finite(double x) {
+  assert(x >= CUSTOM_DBL_MIN && x < CUSTOM_INF_POS);
+  return custom_log_core(x);
+}
+/**
+ * @brief Calculates the square root of a positive, finite, normal x.
+ *
+ * The initial guess halves the biased exponent in the bit pattern and four
+ * Newton steps bring it to full double precision.
+ *
+ * @param x The argument, CUSTOM_DBL_MIN <= x < infinity.
+ * @return The square root of `x`, accurate to double precision.
+ */
+static inline double custom_sqrt_finite(double x) {
+  assert(x >= CUSTOM_DBL_MIN && x < CUSTOM_INF_POS);
+  return custom_sqrt_core(x);
+}
+/**
+ * @brief Calculates the arctangent of x in [-tan(π/8), tan(π/8)].
+ *
+ * Evaluates the odd Taylor series up to x^45 directly on `x`.
+ *
+ * @param x The argument, |x| <= tan(π/8) ≈ 0.4142.
+ * @return The arctangent of `x` in radians, accurate to double precision.
+ */
+static inline double custom_atan_reduced(double x) {
+  assert(x >= -CUSTOM_TAN_PI_8_MAX && x <= CUSTOM_TAN_PI_8_MAX);
+  return custom_atan_core(x);
+}
+int custom_trg_norm(long double *phi);
+
+#endif  // CUSTOM_MATH_H
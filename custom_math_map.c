@@ -0,0 +1,233 @@
+#define _POSIX_C_SOURCE 200809L  // mmap, posix_madvise, ftruncate, pthreads
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "custom_math.h"
+
+#define MAP_DEFAULT_CHUNK_MB 64  // bytes mapped per work item, in MiB
+#define MAP_MAX_THREADS 256
+#define MAP_FLOAT_TILE 4096      // floats widened to double per step
+
+typedef struct {
+  const char *name;
+  custom_expr_code code;
+  int takes_value;  // binary operation with a constant right operand
+} map_step;
+
+static const map_step map_steps[] = {
+    {"neg", CUSTOM_EXPR_NEG, 0},   {"abs", CUSTOM_EXPR_FABS, 0},
+    {"exp", CUSTOM_EXPR_EXP, 0},   {"log", CUSTOM_EXPR_LOG, 0},
+    {"sqrt", CUSTOM_EXPR_SQRT, 0}, {"sin", CUSTOM_EXPR_SIN, 0},
+    {"cos", CUSTOM_EXPR_COS, 0},   {"tan", CUSTOM_EXPR_TAN, 0},
+    {"atan", CUSTOM_EXPR_ATAN, 0}, {"add", CUSTOM_EXPR_ADD, 1},
+    {"sub", CUSTOM_EXPR_SUB, 1},   {"mul", CUSTOM_EXPR_MUL, 1},
+    {"div", CUSTOM_EXPR_DIV, 1},   {"pow", CUSTOM_EXPR_POW, 1},
+};
+
+typedef struct {
+  custom_expr expr;
+  int in_fd, out_fd;
+  size_t file_size, chunk_size, elem_size;
+  atomic_size_t next_chunk;
+  atomic_int failed;
+} map_job;
+
+static void map_usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [-f] [-t threads] [-c chunk_mb] INPUT OUTPUT CHAIN\n"
+          "  Applies CHAIN to every value of INPUT, a file of raw doubles\n"
+          "  (floats with -f), and writes the results to OUTPUT.\n"
+          "  CHAIN is a comma-separated list of steps applied left to right:\n"
+          "    neg abs exp log sqrt sin cos tan atan\n"
+          "    add:C sub:C mul:C div:C pow:C  (x op C for a constant C)\n"
+          "  e.g. \"mul:-0.5,exp,sqrt\" computes sqrt(exp(-0.5 * x)).\n"
+          "  -t  worker threads, default: online processors\n"
+          "  -c  MiB mapped per work item, default %d\n",
+          prog, MAP_DEFAULT_CHUNK_MB);
+}
+
+// Compiles CHAIN into a fused expression over input 0.
+static int map_parse_chain(const char *chain, custom_expr *expr) {
+  custom_expr_op ops[CUSTOM_EXPR_MAX_OPS] = {{CUSTOM_EXPR_INPUT, 0, 0.0}};
+  size_t n_ops = 1;
+  char buf[1024];
+  if (strlen(chain) >= sizeof(buf)) return 1;
+  strcpy(buf, chain);
+  char *save = NULL;
+  for (char *tok = strtok_r(buf, ",", &save); tok;
+       tok = strtok_r(NULL, ",", &save)) {
+    char *arg = strchr(tok, ':');
+    if (arg) *arg++ = '\0';
+    const map_step *step = NULL;
+    for (size_t i = 0; i < sizeof(map_steps) / sizeof(map_steps[0]); i++) {
+      if (strcmp(tok, map_steps[i].name) == 0) step = &map_steps[i];
+    }
+    if (!step || step->takes_value != (arg != NULL)) {
+      fprintf(stderr, "custom_math_map: bad step '%s'\n", tok);
+      return 1;
+    }
+    if (n_ops + 2 > CUSTOM_EXPR_MAX_OPS) {
+      fprintf(stderr, "custom_math_map: chain too long\n");
+      return 1;
+    }
+    if (step->takes_value) {
+      char *end = NULL;
+      double value = strtod(arg, &end);
+      if (end == arg || *end != '\0') {
+        fprintf(stderr, "custom_math_map: bad constant '%s'\n", arg);
+        return 1;
+      }
+      ops[n_ops++] = (custom_expr_op){CUSTOM_EXPR_CONST, 0, value};
+    }
+    ops[n_ops++] = (custom_expr_op){step->code, 0, 0.0};
+  }
+  return custom_expr_build(expr, ops, n_ops);
+}
+
+static void map_float_chunk(const custom_expr *expr, const float *in,
+                            float *out, size_t n) {
+  double tile[MAP_FLOAT_TILE];
+  const double *inputs[] = {tile};
+  for (size_t start = 0; start < n; start += MAP_FLOAT_TILE) {
+    size_t len = n - start < MAP_FLOAT_TILE ? n - start : MAP_FLOAT_TILE;
+    for (size_t i = 0; i < len; i++) tile[i] = in[start + i];
+    custom_expr_eval(expr, inputs, tile, len);
+    for (size_t i = 0; i < len; i++) out[start + i] = (float)tile[i];
+  }
+}
+
+/*
+ * Worker loop. Chunks are claimed in file order and only one chunk of input
+ * and output is mapped per thread at a time, so files larger than memory
+ * stream through the page cache.
+ */
+static void *map_worker(void *arg) {
+  map_job *job = arg;
+  for (;;) {
+    size_t offset = atomic_fetch_add(&job->next_chunk, 1) * job->chunk_size;
+    if (offset >= job->file_size || atomic_load(&job->failed)) break;
+    size_t len = job->file_size - offset;
+    len = len < job->chunk_size ? len : job->chunk_size;
+    off_t pos = (off_t)offset;
+    void *in = mmap(NULL, len, PROT_READ, MAP_SHARED, job->in_fd, pos);
+    void *out =
+        mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, job->out_fd, pos);
+    if (in == MAP_FAILED || out == MAP_FAILED) {
+      perror("custom_math_map: mmap");
+      atomic_store(&job->failed, 1);
+    } else {
+      posix_madvise(in, len, POSIX_MADV_SEQUENTIAL);
+      posix_madvise(out, len, POSIX_MADV_SEQUENTIAL);
+      size_t n = len / job->elem_size;
+      if (job->elem_size == sizeof(double)) {
+        const double *inputs[] = {in};
+        custom_expr_eval(&job->expr, inputs, out, n);
+      } else {
+        map_float_chunk(&job->expr, in, out, n);
+      }
+    }
+    if (in != MAP_FAILED) munmap(in, len);
+    if (out != MAP_FAILED) munmap(out, len);
+  }
+  return NULL;
+}
+
+static double map_now(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+  static map_job job;
+  long threads = 0, chunk_mb = MAP_DEFAULT_CHUNK_MB;
+  job.elem_size = sizeof(double);
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "ft:c:")) != -1) {
+    if (opt == 'f') {
+      job.elem_size = sizeof(float);
+    } else if (opt == 't') {
+      threads = strtol(optarg, NULL, 10);
+    } else if (opt == 'c') {
+      chunk_mb = strtol(optarg, NULL, 10);
+    } else {
+      map_usage(argv[0]);
+      return 1;
+    }
+  }
+  if (argc - optind != 3 || chunk_mb <= 0 || threads < 0 ||
+      threads > MAP_MAX_THREADS) {
+    map_usage(argv[0]);
+    return 1;
+  }
+  if (map_parse_chain(argv[optind + 2], &job.expr)) return 1;
+#ifdef _SC_NPROCESSORS_ONLN
+  if (threads == 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  threads = threads < 1 ? 1 : threads;
+  threads = threads > MAP_MAX_THREADS ? MAP_MAX_THREADS : threads;
+  job.chunk_size = (size_t)chunk_mb << 20;  // a multiple of the page size
+
+  job.in_fd = open(argv[optind], O_RDONLY);
+  if (job.in_fd < 0) {
+    fprintf(stderr, "custom_math_map: %s: %s\n", argv[optind],
+            strerror(errno));
+    return 1;
+  }
+  struct stat st;
+  if (fstat(job.in_fd, &st) != 0 || st.st_size % (off_t)job.elem_size != 0) {
+    fprintf(stderr, "custom_math_map: %s is not a whole number of %s values\n",
+            argv[optind], job.elem_size == sizeof(float) ? "float" : "double");
+    return 1;
+  }
+  job.file_size = (size_t)st.st_size;
+  // OUTPUT is only resized once it is known not to be INPUT, which the
+  // truncation would otherwise destroy before it is read.
+  job.out_fd = open(argv[optind + 1], O_RDWR | O_CREAT, 0644);
+  struct stat out_st;
+  if (job.out_fd < 0 || fstat(job.out_fd, &out_st) != 0) {
+    fprintf(stderr, "custom_math_map: %s: %s\n", argv[optind + 1],
+            strerror(errno));
+    return 1;
+  }
+  if (out_st.st_dev == st.st_dev && out_st.st_ino == st.st_ino) {
+    fprintf(stderr, "custom_math_map: %s and %s are the same file\n",
+            argv[optind], argv[optind + 1]);
+    return 1;
+  }
+  if (ftruncate(job.out_fd, 0) != 0 || ftruncate(job.out_fd, st.st_size) != 0) {
+    fprintf(stderr, "custom_math_map: %s: %s\n", argv[optind + 1],
+            strerror(errno));
+    return 1;
+  }
+
+  pthread_t pool[MAP_MAX_THREADS];
+  double start = map_now();
+  long started = 0;
+  for (; started < threads; started++) {
+    if (pthread_create(&pool[started], NULL, map_worker, &job) != 0) break;
+  }
+  if (started == 0) map_worker(&job);
+  for (long i = 0; i < started; i++) pthread_join(pool[i], NULL);
+  double elapsed = map_now() - start;
+  close(job.in_fd);
+  if (close(job.out_fd) != 0 || atomic_load(&job.failed)) return 1;
+
+  double gb = job.file_size / 1e9;
+  printf("%zu values, %.3f GB in %.3f s with %ld threads: %.3f GB/s, "
+         "%.1f M values/s\n",
+         job.file_size / job.elem_size, gb, elapsed, started ? started : 1,
+         elapsed > 0 ? gb / elapsed : 0.0,
+         elapsed > 0 ? job.file_size / job.elem_size / elapsed / 1e6 : 0.0);
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include <check.h>
+#include <complex.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -65,6 +66,9 @@ START_TEST(test_fmod) {
       }
     }
   }
+  ck_assert_ldouble_eq(custom_fmod(5.5, INFINITY), fmod(5.5, INFINITY));
+  ck_assert_ldouble_nan(custom_fmod(INFINITY, 2.0));
+  ck_assert_ldouble_nan(custom_fmod(1.0, NAN));
 }
 END_TEST
 
@@ -99,6 +103,55 @@ START_TEST(test_factorial) {
   ck_assert_ldouble_nan(custom_factorial(-1));
   ck_assert_ldouble_nan(custom_factorial(-5));
   ck_assert_ldouble_nan(custom_factorial(-10));
+  ck_assert_ldouble_eq(custom_factorial(25), 15511210043330985984000000.0L);
+  for (int n = 26; n <= CUSTOM_FACTORIAL_MAX; n += 17) {
+    long double expected = tgammal(n + 1.0L);
+    ck_assert_ldouble_eq_tol(custom_factorial(n), expected, 4e-15L * expected);
+  }
+  ck_assert_ldouble_eq(custom_factorial(CUSTOM_FACTORIAL_MAX + 1), INFINITY);
+}
+END_TEST
+
+START_TEST(test_tgamma) {
+  for (double x = -20.05; x <= 170.0; x += 0.37) {
+    long double expected = tgammal(x);
+    ck_assert_ldouble_eq_tol(custom_tgamma(x), expected,
+                             1e-15L * fabsl(expected));
+  }
+  ck_assert_ldouble_eq(custom_tgamma(1.0), 1.0);
+  ck_assert_ldouble_eq(custom_tgamma(5.0), 24.0);
+  ck_assert_ldouble_eq_tol(custom_tgamma(0.5), 1.7724538509055160273L,
+                           4e-18L);
+  // the exponential scales by 2^16384 close to the overflow point
+  for (double x = 1755.0; x < 1755.53; x += 0.01) {
+    long double expected = tgammal(x);
+    ck_assert_ldouble_eq_tol(custom_tgamma(x), expected, 4e-15L * expected);
+  }
+  ck_assert_ldouble_eq(custom_tgamma(1755.6), INFINITY);
+  ck_assert_ldouble_eq(custom_tgamma(1800.0), INFINITY);
+  ck_assert_ldouble_eq(custom_tgamma(INFINITY), INFINITY);
+  ck_assert_ldouble_eq(custom_tgamma(0.0), INFINITY);
+  ck_assert_ldouble_eq(custom_tgamma(-0.0), -INFINITY);
+  ck_assert_ldouble_nan(custom_tgamma(-3.0));
+  ck_assert_ldouble_nan(custom_tgamma(-INFINITY));
+  ck_assert_ldouble_nan(custom_tgamma(NAN));
+}
+END_TEST
+
+START_TEST(test_lgamma) {
+  for (double x = -20.05; x <= 3000.0; x += 1.37) {
+    long double expected = lgammal(x);
+    ck_assert_ldouble_eq_tol(custom_lgamma(x), expected,
+                             1e-17L * (1 + fabsl(expected)));
+  }
+  ck_assert_ldouble_eq(custom_lgamma(1.0), 0.0);
+  ck_assert_ldouble_eq(custom_lgamma(2.0), 0.0);
+  ck_assert_ldouble_eq_tol(custom_lgamma(1e300), lgammal(1e300),
+                           1e-17L * lgammal(1e300));
+  ck_assert_ldouble_eq(custom_lgamma(0.0), INFINITY);
+  ck_assert_ldouble_eq(custom_lgamma(-4.0), INFINITY);
+  ck_assert_ldouble_eq(custom_lgamma(-INFINITY), INFINITY);
+  ck_assert_ldouble_nan(custom_lgamma(NAN));
 }
 END_TEST
 
@@ -133,6 +186,20 @@ START_TEST(test_pow) {
   ck_assert_double_eq(custom_pow(0, -INFINITY), pow(0, -INFINITY));
   ck_assert_double_eq_tol(custom_pow(0, INFINITY), pow(0, INFINITY), 0.000001);
   ck_assert_double_nan(custom_pow(0, NAN));
+  ck_assert_double_eq(custom_pow(1, NAN), pow(1, NAN));
+  ck_assert_double_eq(custom_pow(-1, INFINITY), pow(-1, INFINITY));
+  ck_assert_double_eq(custom_pow(-0.5, -INFINITY), pow(-0.5, -INFINITY));
+  // -0 keeps its sign for odd exponents in both modes
+  for (int det = 0; det <= 1; det++) {
+    custom_set_deterministic(det);
+    ck_assert_double_eq(custom_pow(-0.0, 3.0), 0.0);
+    ck_assert_int_eq(custom_signbit(custom_pow(-0.0, 3.0)), 1);
+    ck_assert_double_eq(custom_pow(-0.0, -3.0), -INFINITY);
+    ck_assert_double_eq(custom_pow(-0.0, 2.0), 0.0);
+    ck_assert_int_eq(custom_signbit(custom_pow(-0.0, 2.0)), 0);
+    ck_assert_double_eq(custom_pow(-0.0, -2.0), INFINITY);
+  }
+  custom_set_deterministic(0);
 }
 END_TEST
 
@@ -164,6 +231,8 @@ START_TEST(test_atan) {
                   "atan result %.16Lf",
                   x, result, expected);
   }
+  ck_assert_double_eq_tol(custom_atan(5.0), atan(5.0), CUSTOM_TRG_PRC);
+  ck_assert_double_eq_tol(custom_atan(-123.0), atan(-123.0), CUSTOM_TRG_PRC);
   ck_assert_double_eq(custom_atan(INFINITY), atan(INFINITY));
   ck_assert_double_nan(custom_atan(NAN));
   ck_assert_double_eq(custom_atan(-INFINITY), atan(-INFINITY));
@@ -297,12 +366,750 @@ START_TEST(test_sqrt) {
 }
 END_TEST
 
+START_TEST(test_logsumexp) {
+  double x[64];
+  for (int i = 0; i < 64; i++) x[i] = -20.0 + 0.6 * i;
+  long double expected = 0.0;
+  for (int i = 0; i < 64; i++) expected += expl(x[i]);
+  expected = logl(expected);
+  ck_assert_ldouble_eq_tol(custom_logsumexp(x, 64), expected, 1e-12);
+
+  double big[] = {1000.0, 1001.0, 999.5};
+  expected = 1001.0 + log(exp(-1.0) + 1.0 + exp(-1.5));
+  ck_assert_ldouble_eq_tol(custom_logsumexp(big, 3), expected, 1e-12);
+
+  double single[] = {-3.25};
+  ck_assert_ldouble_eq_tol(custom_logsumexp(single, 1), -3.25, 1e-15);
+  ck_assert_ldouble_eq(custom_logsumexp(x, 0), -INFINITY);
+  double with_inf[] = {1.0, INFINITY};
+  ck_assert_ldouble_eq(custom_logsumexp(with_inf, 2), INFINITY);
+  double with_nan[] = {1.0, NAN, 2.0};
+  ck_assert_ldouble_nan(custom_logsumexp(with_nan, 3));
+}
+END_TEST
+
+START_TEST(test_softmax) {
+  double x[37], out[37];
+  for (int i = 0; i < 37; i++) x[i] = 500.0 + 0.37 * i * (i % 2 ? 1 : -1);
+  custom_softmax(x, out, 37);
+  double max = x[0];
+  for (int i = 1; i < 37; i++) max = x[i] > max ? x[i] : max;
+  long double sum = 0.0;
+  for (int i = 0; i < 37; i++) sum += expl(x[i] - max);
+  long double total = 0.0;
+  for (int i = 0; i < 37; i++) {
+    ck_assert_ldouble_eq_tol(out[i], expl(x[i] - max) / sum, 1e-15);
+    total += out[i];
+  }
+  ck_assert_ldouble_eq_tol(total, 1.0, 1e-14);
+
+  custom_softmax(x, x, 37);
+  for (int i = 0; i < 37; i++) ck_assert_ldouble_eq(x[i], out[i]);
+
+  double with_inf[] = {INFINITY, 3.0, INFINITY};
+  custom_softmax(with_inf, out, 3);
+  ck_assert_ldouble_eq(out[0], 0.5);
+  ck_assert_ldouble_eq(out[1], 0.0);
+  ck_assert_ldouble_eq(out[2], 0.5);
+  double all_neg_inf[] = {-INFINITY, -INFINITY, -INFINITY, -INFINITY};
+  custom_softmax(all_neg_inf, out, 4);
+  for (int i = 0; i < 4; i++) ck_assert_ldouble_eq(out[i], 0.25);
+  double with_nan[] = {1.0, NAN};
+  custom_softmax(with_nan, out, 2);
+  ck_assert_ldouble_nan(out[0]);
+  ck_assert_ldouble_nan(out[1]);
+}
+END_TEST
+
+START_TEST(test_cexp) {
+  double complex z[] = {0.0,       1.0 + 2.0 * I,   -3.5 + 0.25 * I,
+                        40.0 - 7.0 * I, -700.0 + 1.0 * I, 0.5 - 1000.0 * I};
+  size_t n = sizeof(z) / sizeof(z[0]);
+  double complex out[6];
+  double re[6], im[6], out_re[6], out_im[6];
+  for (size_t i = 0; i < n; i++) {
+    double complex expected = cexp(z[i]);
+    double complex result = custom_cexp(z[i]);
+    ck_assert_double_eq_tol(creal(result), creal(expected),
+                            1e-14 * cabs(expected) + 1e-300);
+    ck_assert_double_eq_tol(cimag(result), cimag(expected),
+                            1e-14 * cabs(expected) + 1e-300);
+    re[i] = creal(z[i]);
+    im[i] = cimag(z[i]);
+  }
+  custom_cexp_array(z, out, n);
+  custom_cexp_split(re, im, out_re, out_im, n);
+  for (size_t i = 0; i < n; i++) {
+    ck_assert_double_eq(creal(out[i]), creal(custom_cexp(z[i])));
+    ck_assert_double_eq(cimag(out[i]), cimag(custom_cexp(z[i])));
+    ck_assert_double_eq(out_re[i], creal(out[i]));
+    ck_assert_double_eq(out_im[i], cimag(out[i]));
+  }
+  ck_assert_double_eq(creal(custom_cexp(-INFINITY)), 0.0);
+  ck_assert_double_eq(creal(custom_cexp(INFINITY)), INFINITY);
+  ck_assert_double_eq_tol(creal(custom_cexp(709.5)), exp(709.5),
+                          1e-15 * exp(709.5));
+  ck_assert_double_nan(creal(custom_cexp(CMPLX(0.0, NAN))));
+}
+END_TEST
+
+START_TEST(test_clog) {
+  double complex z[] = {1.0,        -1.0,           2.0 + 3.0 * I,
+                        -0.5 - 4.0 * I, 1e300 + 1e300 * I, 1e-310 - 1e-310 * I,
+                        -7.0 * I,   0.999 + 0.01 * I};
+  size_t n = sizeof(z) / sizeof(z[0]);
+  double complex out[8];
+  double re[8], im[8], out_re[8], out_im[8];
+  for (size_t i = 0; i < n; i++) {
+    double complex expected = clog(z[i]);
+    double complex result = custom_clog(z[i]);
+    ck_assert_double_eq_tol(creal(result), creal(expected), 1e-13);
+    ck_assert_double_eq_tol(cimag(result), cimag(expected), 1e-14);
+    re[i] = creal(z[i]);
+    im[i] = cimag(z[i]);
+  }
+  custom_clog_array(z, out, n);
+  custom_clog_split(re, im, out_re, out_im, n);
+  for (size_t i = 0; i < n; i++) {
+    ck_assert_double_eq(out_re[i], creal(out[i]));
+    ck_assert_double_eq(out_im[i], cimag(out[i]));
+  }
+  ck_assert_double_eq(creal(custom_clog(0.0)), -INFINITY);
+  ck_assert_double_eq(creal(custom_clog(CMPLX(INFINITY, 1.0))), INFINITY);
+  ck_assert_double_nan(creal(custom_clog(CMPLX(NAN, 1.0))));
+  // the sign of a zero imaginary part selects the side of the branch cut
+  ck_assert_double_eq(cimag(custom_clog(CMPLX(-1.0, 0.0))), CUSTOM_PI);
+  ck_assert_double_eq(cimag(custom_clog(CMPLX(-1.0, -0.0))), -CUSTOM_PI);
+  ck_assert_double_eq(cimag(custom_clog(CMPLX(-0.0, -0.0))), -CUSTOM_PI);
+}
+END_TEST
+
+START_TEST(test_cpow) {
+  double complex z[] = {2.0, -2.0, 1.0 + 1.0 * I, 0.5 - 3.0 * I, -1.0};
+  double complex w[] = {3.0, 2.0, 0.5 - 2.0 * I, 2.5, 0.5};
+  size_t n = sizeof(z) / sizeof(z[0]);
+  double complex out[5];
+  double re[5], im[5], w_re[5], w_im[5], out_re[5], out_im[5];
+  for (size_t i = 0; i < n; i++) {
+    double complex expected = cpow(z[i], w[i]);
+    double complex result = custom_cpow(z[i], w[i]);
+    ck_assert_double_eq_tol(creal(result), creal(expected),
+                            1e-13 * cabs(expected));
+    ck_assert_double_eq_tol(cimag(result), cimag(expected),
+                            1e-13 * cabs(expected));
+    re[i] = creal(z[i]);
+    im[i] = cimag(z[i]);
+    w_re[i] = creal(w[i]);
+    w_im[i] = cimag(w[i]);
+  }
+  custom_cpow_array(z, w, out, n);
+  custom_cpow_split(re, im, w_re, w_im, out_re, out_im, n);
+  for (size_t i = 0; i < n; i++) {
+    ck_assert_double_eq(out_re[i], creal(out[i]));
+    ck_assert_double_eq(out_im[i], cimag(out[i]));
+  }
+  ck_assert_double_eq(creal(custom_cpow(0.0, 0.0)), 1.0);
+  ck_assert_double_eq(creal(custom_cpow(0.0, 2.0 + I)), 0.0);
+  ck_assert_double_nan(creal(custom_cpow(0.0, -1.0)));
+}
+END_TEST
+
+START_TEST(test_csin) {
+  double complex z[] = {0.0, 1.0 + 2.0 * I, -3.5 + 0.25 * I, 40.0 - 7.0 * I,
+                        0.1 - 1e-9 * I};
+  size_t n = sizeof(z) / sizeof(z[0]);
+  double complex out[5];
+  double re[5], im[5], out_re[5], out_im[5];
+  for (size_t i = 0; i < n; i++) {
+    double complex expected = csin(z[i]);
+    double complex result = custom_csin(z[i]);
+    ck_assert_double_eq_tol(creal(result), creal(expected),
+                            1e-14 * cabs(expected) + 1e-300);
+    ck_assert_double_eq_tol(cimag(result), cimag(expected),
+                            1e-14 * cabs(expected) + 1e-300);
+    re[i] = creal(z[i]);
+    im[i] = cimag(z[i]);
+  }
+  custom_csin_array(z, out, n);
+  custom_csin_split(re, im, out_re, out_im, n);
+  for (size_t i = 0; i < n; i++) {
+    ck_assert_double_eq(out_re[i], creal(out[i]));
+    ck_assert_double_eq(out_im[i], cimag(out[i]));
+  }
+  ck_assert_double_nan(creal(custom_csin(INFINITY)));
+  // large imaginary parts: exact zeros and no early overflow
+  double complex big = custom_csin(CMPLX(0.0, 1000.0));
+  ck_assert_double_eq(creal(big), 0.0);
+  ck_assert_double_eq(cimag(big), INFINITY);
+  for (double b = 709.5; b < 710.47; b += 0.19) {
+    double complex expected = csin(CMPLX(0.3, b));
+    double complex result = custom_csin(CMPLX(0.3, b));
+    ck_assert_double_eq_tol(creal(result), creal(expected),
+                            1e-14 * cabs(expected));
+    ck_assert_double_eq_tol(cimag(result), cimag(expected),
+                            1e-14 * cabs(expected));
+  }
+  ck_assert_double_eq_tol(cimag(custom_csin(CMPLX(0.0, 709.5))), sinh(709.5),
+                          1e-14 * sinh(709.5));
+}
+END_TEST
+
+START_TEST(test_ccos) {
+  double complex z[] = {0.0, 1.0 + 2.0 * I, -3.5 + 0.25 * I, 40.0 - 7.0 * I,
+                        CUSTOM_PI / 2};
+  size_t n = sizeof(z) / sizeof(z[0]);
+  double complex out[5];
+  double re[5], im[5], out_re[5], out_im[5];
+  for (size_t i = 0; i < n; i++) {
+    double complex expected = ccos(z[i]);
+    double complex result = custom_ccos(z[i]);
+    ck_assert_double_eq_tol(creal(result), creal(expected),
+                            1e-14 * cabs(expected) + 1e-16);
+    ck_assert_double_eq_tol(cimag(result), cimag(expected),
+                            1e-14 * cabs(expected) + 1e-16);
+    re[i] = creal(z[i]);
+    im[i] = cimag(z[i]);
+  }
+  custom_ccos_array(z, out, n);
+  custom_ccos_split(re, im, out_re, out_im, n);
+  for (size_t i = 0; i < n; i++) {
+    ck_assert_double_eq(out_re[i], creal(out[i]));
+    ck_assert_double_eq(out_im[i], cimag(out[i]));
+  }
+  ck_assert_double_nan(creal(custom_ccos(NAN)));
+  double complex big = custom_ccos(CMPLX(0.0, 1000.0));
+  ck_assert_double_eq(creal(big), INFINITY);
+  ck_assert_double_eq(cimag(big), 0.0);
+  ck_assert_int_eq(custom_signbit(cimag(big)), 1);
+  ck_assert_double_eq_tol(creal(custom_ccos(CMPLX(0.0, 710.4))),
+                          cosh(710.4), 1e-14 * cosh(710.4));
+}
+END_TEST
+
+START_TEST(test_csqrt) {
+  double complex z[] = {4.0,        -4.0,           2.0 + 3.0 * I,
+                        -0.5 - 4.0 * I, 1e300 - 1e300 * I, 1e-310 + 1e-310 * I,
+                        -7.0 * I,   1e-20 - 1.0 * I};
+  size_t n = sizeof(z) / sizeof(z[0]);
+  double complex out[8];
+  double re[8], im[8], out_re[8], out_im[8];
+  for (size_t i = 0; i < n; i++) {
+    double complex expected = csqrt(z[i]);
+    double complex result = custom_csqrt(z[i]);
+    ck_assert_double_eq_tol(creal(result), creal(expected),
+                            1e-15 * cabs(expected));
+    ck_assert_double_eq_tol(cimag(result), cimag(expected),
+                            1e-15 * cabs(expected));
+    re[i] = creal(z[i]);
+    im[i] = cimag(z[i]);
+  }
+  custom_csqrt_array(z, out, n);
+  custom_csqrt_split(re, im, out_re, out_im, n);
+  for (size_t i = 0; i < n; i++) {
+    ck_assert_double_eq(out_re[i], creal(out[i]));
+    ck_assert_double_eq(out_im[i], cimag(out[i]));
+  }
+  ck_assert_double_eq(creal(custom_csqrt(0.0)), 0.0);
+  ck_assert_double_eq(creal(custom_csqrt(CMPLX(1.0, INFINITY))), INFINITY);
+  ck_assert_double_eq(cimag(custom_csqrt(CMPLX(1.0, INFINITY))), INFINITY);
+  double complex below = custom_csqrt(CMPLX(-4.0, -0.0));
+  ck_assert_double_eq(creal(below), 0.0);
+  ck_assert_double_eq(cimag(below), -2.0);
+  ck_assert_double_eq(cimag(custom_csqrt(CMPLX(-4.0, 0.0))), 2.0);
+}
+END_TEST
+
+START_TEST(test_sin_fixed) {
+  int32_t x16[64], x31[64], out16[64], out31[64];
+  for (int i = 0; i < 64; i++) {
+    x16[i] = (int32_t)((i - 32) * 0.37 * 65536);
+    x31[i] = (int32_t)((i - 32) * 67108864.0);  // steps of π/32
+  }
+  custom_sin_q16_array(x16, out16, 64);
+  custom_sin_q31_array(x31, out31, 64);
+  for (int i = 0; i < 64; i++) {
+    ck_assert_double_eq_tol(out16[i] / 65536.0, custom_sin(x16[i] / 65536.0),
+                            3.0 / 65536);
+    ck_assert_double_eq_tol(out31[i] / 2147483648.0,
+                            custom_sin((i - 32) * CUSTOM_PI / 32),
+                            2 * CUSTOM_TRG_PRC);
+    ck_assert_int_eq(out16[i], custom_sin_q16(x16[i]));
+    ck_assert_int_eq(out31[i], custom_sin_q31(x31[i]));
+  }
+  ck_assert_double_eq_tol(custom_sin_q16(INT32_MAX) / 65536.0,
+                          sin(INT32_MAX / 65536.0), 2.0 / 65536);
+  ck_assert_int_eq(custom_sin_q31(1 << 30), INT32_MAX);
+  ck_assert_int_le(abs(custom_sin_q31(INT32_MIN)), 16);
+}
+END_TEST
+
+START_TEST(test_cos_fixed) {
+  int32_t x16[64], x31[64], out16[64], out31[64];
+  for (int i = 0; i < 64; i++) {
+    x16[i] = (int32_t)((i - 32) * 0.37 * 65536);
+    x31[i] = (int32_t)((i - 32) * 67108864.0);
+  }
+  custom_cos_q16_array(x16, out16, 64);
+  custom_cos_q31_array(x31, out31, 64);
+  for (int i = 0; i < 64; i++) {
+    ck_assert_double_eq_tol(out16[i] / 65536.0, custom_cos(x16[i] / 65536.0),
+                            3.0 / 65536);
+    ck_assert_double_eq_tol(out31[i] / 2147483648.0,
+                            custom_cos((i - 32) * CUSTOM_PI / 32),
+                            2 * CUSTOM_TRG_PRC);
+    ck_assert_int_eq(out16[i], custom_cos_q16(x16[i]));
+    ck_assert_int_eq(out31[i], custom_cos_q31(x31[i]));
+  }
+  ck_assert_int_eq(custom_cos_q16(0), 65536);
+  ck_assert_int_eq(custom_cos_q31(0), INT32_MAX);
+  ck_assert_int_eq(custom_cos_q31(INT32_MIN), INT32_MIN);
+}
+END_TEST
+
+START_TEST(test_sqrt_fixed) {
+  int32_t x16[] = {0, 1, 65536, 4 * 65536, 131072, 1000, INT32_MAX, -5};
+  int32_t x31[] = {0, 1, 1 << 30, 1 << 29, 123456789, INT32_MAX, -1, INT32_MIN};
+  int32_t out16[8], out31[8];
+  custom_sqrt_q16_array(x16, out16, 8);
+  custom_sqrt_q31_array(x31, out31, 8);
+  for (int i = 0; i < 6; i++) {
+    ck_assert_double_eq_tol(out16[i] / 65536.0,
+                            custom_sqrt(x16[i] / 65536.0), 0.5 / 65536);
+    ck_assert_double_eq_tol(out31[i] / 2147483648.0,
+                            custom_sqrt(x31[i] / 2147483648.0), 1e-9);
+  }
+  ck_assert_int_eq(out16[2], 65536);
+  ck_assert_int_eq(out16[3], 131072);
+  ck_assert_int_eq(out31[2], 1518500250);
+  ck_assert_int_eq(out31[5], INT32_MAX);
+  ck_assert_int_eq(out16[7], INT32_MIN);
+  ck_assert_int_eq(out31[6], INT32_MIN);
+  ck_assert_int_eq(out31[7], INT32_MIN);
+}
+END_TEST
+
+START_TEST(test_exp_fixed) {
+  int32_t x16[48], x31[48], out16[48], out31[48];
+  for (int i = 0; i < 48; i++) {
+    x16[i] = (int32_t)((i - 36) * 0.29 * 65536);
+    x31[i] = (int32_t)(-i * 44739242.0);
+  }
+  custom_exp_q16_array(x16, out16, 48);
+  custom_exp_q31_array(x31, out31, 48);
+  for (int i = 0; i < 48; i++) {
+    long double expected = custom_exp(x16[i] / 65536.0);
+    ck_assert_double_eq_tol(out16[i] / 65536.0, expected,
+                            1.0 / 65536 + expected * 1e-8);
+    ck_assert_double_eq_tol(out31[i] / 2147483648.0,
+                            custom_exp(x31[i] / 2147483648.0), 1e-8);
+  }
+  ck_assert_int_eq(custom_exp_q16(0), 65536);
+  ck_assert_int_eq(custom_exp_q16(11 << 16), INT32_MAX);
+  ck_assert_int_eq(custom_exp_q16(INT32_MIN), 0);
+  ck_assert_int_eq(custom_exp_q31(0), INT32_MAX);
+  ck_assert_int_eq(custom_exp_q31(1 << 30), INT32_MAX);
+}
+END_TEST
+
+START_TEST(test_log_fixed) {
+  int32_t x16[] = {1, 100, 30000, 65536, 100000, 1 << 24, INT32_MAX, 0, -7};
+  int32_t x31[] = {INT32_MAX, 1 << 30, 1600000000, 800000000, 1, 0, -1};
+  int32_t out16[9], out31[7];
+  custom_log_q16_array(x16, out16, 9);
+  custom_log_q31_array(x31, out31, 7);
+  for (int i = 0; i < 7; i++) {
+    ck_assert_double_eq_tol(out16[i] / 65536.0, log(x16[i] / 65536.0),
+                            1.0 / 65536);
+  }
+  for (int i = 0; i < 4; i++) {
+    ck_assert_double_eq_tol(out31[i] / 2147483648.0,
+                            custom_log(x31[i] / 2147483648.0), 1e-8);
+  }
+  ck_assert_int_eq(out16[3], 0);
+  ck_assert_int_eq(out16[7], INT32_MIN);
+  ck_assert_int_eq(out16[8], INT32_MIN);
+  ck_assert_int_eq(out31[4], INT32_MIN);
+  ck_assert_int_eq(out31[5], INT32_MIN);
+  ck_assert_int_eq(out31[6], INT32_MIN);
+}
+END_TEST
+
+START_TEST(test_atan2_fixed) {
+  int32_t y[] = {0, 65536, -65536, 3, 1000000, -2000000000, 0, 7, -7};
+  int32_t x[] = {65536, 65536, 65536, 5, -1000000, 1, -65536, 0, -1};
+  int32_t out16[9], out31[9];
+  custom_atan2_q16_array(y, x, out16, 9);
+  custom_atan2_q31_array(y, x, out31, 9);
+  for (int i = 0; i < 9; i++) {
+    double expected = atan2(y[i], x[i]);
+    if (x[i] > 0 && y[i] <= x[i] && y[i] >= -x[i]) {
+      ck_assert_double_eq_tol(expected, custom_atan((double)y[i] / x[i]),
+                              CUSTOM_TRG_PRC);
+    }
+    ck_assert_double_eq_tol(out16[i] / 65536.0, expected, 1.0 / 65536);
+    ck_assert_double_eq_tol(out31[i] / 2147483648.0, expected / CUSTOM_PI,
+                            1e-8);
+  }
+  ck_assert_int_eq(custom_atan2_q16(0, 0), 0);
+  ck_assert_int_ge(custom_atan2_q31(0, -1), INT32_MAX - 16);
+  ck_assert_int_le(abs(custom_atan2_q31(65536, 0) - (1 << 30)), 16);
+}
+END_TEST
+
+START_TEST(test_expr) {
+  enum { N = 1000 };
+  static double x[N], y[N], out[N];
+  for (int i = 0; i < N; i++) {
+    x[i] = -3.0 + 0.006 * i;
+    y[i] = 0.013 * i - 5.0;
+  }
+  custom_expr_op ops[] = {
+      {CUSTOM_EXPR_INPUT, 0, 0.0}, {CUSTOM_EXPR_CONST, 0, 2.0},
+      {CUSTOM_EXPR_POW, 0, 0.0},   {CUSTOM_EXPR_NEG, 0, 0.0},
+      {CUSTOM_EXPR_EXP, 0, 0.0},   {CUSTOM_EXPR_INPUT, 1, 0.0},
+      {CUSTOM_EXPR_COS, 0, 0.0},   {CUSTOM_EXPR_MUL, 0, 0.0}};
+  custom_expr expr;
+  ck_assert_int_eq(custom_expr_build(&expr, ops, 8), 0);
+  const double *inputs[] = {x, y};
+  custom_expr_eval(&expr, inputs, out, N);
+  for (int i = 0; i < N; i++) {
+    ck_assert_double_eq_tol(out[i], exp(-pow(x[i], 2)) * cos(y[i]), 1e-15);
+  }
+
+  custom_expr_op all[] = {
+      {CUSTOM_EXPR_INPUT, 0, 0.0}, {CUSTOM_EXPR_FABS, 0, 0.0},
+      {CUSTOM_EXPR_SQRT, 0, 0.0},  {CUSTOM_EXPR_LOG, 0, 0.0},
+      {CUSTOM_EXPR_INPUT, 1, 0.0}, {CUSTOM_EXPR_SIN, 0, 0.0},
+      {CUSTOM_EXPR_INPUT, 1, 0.0}, {CUSTOM_EXPR_TAN, 0, 0.0},
+      {CUSTOM_EXPR_ATAN, 0, 0.0},  {CUSTOM_EXPR_DIV, 0, 0.0},
+      {CUSTOM_EXPR_SUB, 0, 0.0},   {CUSTOM_EXPR_CONST, 0, 0.5},
+      {CUSTOM_EXPR_ADD, 0, 0.0}};
+  ck_assert_int_eq(custom_expr_build(&expr, all, 13), 0);
+  custom_expr_eval(&expr, inputs, x, N);
+  for (int i = 0; i < N; i++) {
+    double xi = -3.0 + 0.006 * i;
+    double expected = log(sqrt(fabs(xi))) - sin(y[i]) / atan(tan(y[i])) + 0.5;
+    if (isinf(expected)) {
+      ck_assert_double_eq(x[i], expected);
+    } else {
+      ck_assert_double_eq_tol(x[i], expected, 1e-12);
+    }
+  }
+
+  custom_expr_op underflow[] = {{CUSTOM_EXPR_INPUT, 0, 0.0},
+                                {CUSTOM_EXPR_ADD, 0, 0.0}};
+  custom_expr_op leftover[] = {{CUSTOM_EXPR_INPUT, 0, 0.0},
+                               {CUSTOM_EXPR_INPUT, 1, 0.0}};
+  custom_expr_op bad_input[] = {{CUSTOM_EXPR_INPUT, CUSTOM_EXPR_MAX_INPUTS, 0.0}};
+  custom_expr_op deep[CUSTOM_EXPR_MAX_DEPTH + 1];
+  for (int i = 0; i <= CUSTOM_EXPR_MAX_DEPTH; i++) {
+    deep[i] = (custom_expr_op){CUSTOM_EXPR_CONST, 0, 1.0};
+  }
+  ck_assert_int_eq(custom_expr_build(&expr, underflow, 2), 1);
+  ck_assert_int_eq(custom_expr_build(&expr, leftover, 2), 1);
+  ck_assert_int_eq(custom_expr_build(&expr, bad_input, 1), 1);
+  ck_assert_int_eq(custom_expr_build(&expr, deep, CUSTOM_EXPR_MAX_DEPTH + 1), 1);
+  ck_assert_int_eq(custom_expr_build(&expr, ops, 0), 1);
+}
+END_TEST
+
+START_TEST(test_deterministic) {
+  ck_assert_int_eq(custom_is_deterministic(), 0);
+  custom_set_deterministic(1);
+  ck_assert_int_eq(custom_is_deterministic(), 1);
+  for (double x = -20.0; x <= 20.0; x += 0.37) {
+    ck_assert_double_eq_tol(custom_sin(x), sin(x), 1e-15);
+    ck_assert_double_eq_tol(custom_cos(x), cos(x), 1e-15);
+    ck_assert_double_eq_tol(custom_tan(x), tan(x), 1e-13 * (1 + fabs(tan(x))));
+    ck_assert_double_eq_tol(custom_atan(x), atan(x), 1e-15);
+    ck_assert_double_eq_tol(custom_exp(x), exp(x), 1e-15 * exp(x));
+    if (x > 0) {
+      ck_assert_double_eq_tol(custom_log(x), log(x), 1e-15);
+      ck_assert_double_eq_tol(custom_sqrt(x), sqrt(x), 1e-15);
+      ck_assert_double_eq_tol(custom_pow(x, 1.7), pow(x, 1.7),
+                              1e-14 * pow(x, 1.7));
+    }
+  }
+  // the reduction stays exact up to the kernel limit
+  for (double x = CUSTOM_TRG_MAX_ARG - 1e7; x < CUSTOM_TRG_MAX_ARG;
+       x += 1e5 + 0.3) {
+    ck_assert_double_eq_tol(custom_sin(x), sin(x), 1e-15);
+    ck_assert_double_eq_tol(custom_cos(x), cos(x), 1e-15);
+  }
+  ck_assert_double_nan(custom_sin(CUSTOM_TRG_MAX_ARG));
+  for (double x = -1.0; x <= 1.0; x += 0.125) {
+    ck_assert_double_eq_tol(custom_asin(x), asin(x), 1e-15);
+    ck_assert_double_eq_tol(custom_acos(x), acos(x), 1e-15);
+  }
+  ck_assert_ldouble_eq(custom_pow(2.0, 10.0), 1024.0);
+  ck_assert_ldouble_eq(custom_pow(-2.0, 3.0), -8.0);
+  ck_assert_ldouble_eq(custom_pow(0.5, -2.0), 4.0);
+  ck_assert_double_eq_tol(custom_pow(-1.5, 2001.0), pow(-1.5, 2001.0),
+                          1e-12 * fabs(pow(-1.5, 2001.0)));
+  ck_assert_ldouble_eq(custom_factorial(10), 3628800.0);
+  ck_assert_ldouble_eq(custom_factorial(CUSTOM_FACTORIAL_MAX + 1), INFINITY);
+  ck_assert_double_nan(custom_sin(INFINITY));
+  ck_assert_double_nan(custom_cos(NAN));
+  ck_assert_double_nan(custom_sqrt(-1.0));
+  ck_assert_double_nan(custom_sqrt(NAN));
+  ck_assert_double_nan(custom_log(-1.0));
+  ck_assert_double_eq(custom_log(0.0), -INFINITY);
+  ck_assert_double_eq(custom_exp(-INFINITY), 0.0);
+  // 2^1024 is applied in two steps just below the overflow point
+  for (double x = 709.0; x < 709.78; x += 0.13) {
+    ck_assert_double_eq_tol(custom_exp(x), exp(x), 1e-15 * exp(x));
+  }
+  ck_assert_double_eq(custom_exp(709.79), INFINITY);
+  ck_assert_double_eq(custom_atan(INFINITY), CUSTOM_PI / 2);
+  custom_set_deterministic(0);
+  ck_assert_int_eq(custom_is_deterministic(), 0);
+}
+END_TEST
+
+START_TEST(test_unchecked) {
+  for (double x = -0.785; x <= 0.785; x += 0.0157) {
+    ck_assert_double_eq_tol(custom_sin_reduced(x), sin(x), 2e-16);
+    ck_assert_double_eq_tol(custom_cos_reduced(x), cos(x), 2e-16);
+  }
+  for (double x = -0.5; x <= 0.5; x += 0.01) {
+    ck_assert_double_eq_tol(custom_exp_reduced(x), exp(x), 4e-16 * exp(x));
+  }
+  for (double x = -1.0; x <= 0.0; x += 0.02) {
+    ck_assert_double_eq_tol(custom_exp_small(x), exp(x), 4e-16 * exp(x));
+  }
+  for (double x = -0.414; x <= 0.414; x += 0.0069) {
+    ck_assert_double_eq_tol(custom_atan_reduced(x), atan(x), 2e-16);
+  }
+  for (double x = 1e-300; x < 1e300; x *= 7.3) {
+    ck_assert_double_eq_tol(custom_sqrt_finite(x), sqrt(x), 4e-16 * sqrt(x));
+    ck_assert_double_eq_tol(custom_log_finite(x), log(x),
+                            4e-16 * (1 + fabs(log(x))));
+  }
+  ck_assert_double_eq(custom_sin_reduced(0.0), 0.0);
+  ck_assert_double_eq(custom_cos_reduced(0.0), 1.0);
+  ck_assert_double_eq(custom_exp_small(0.0), exp(0.0));
+  ck_assert_double_eq(custom_sqrt_finite(4.0), 2.0);
+  ck_assert_double_eq(custom_log_finite(1.0), 0.0);
+}
+END_TEST
+
+START_TEST(test_randu) {
+  static double a[10000], b[10000];
+  custom_rng r1, r2;
+  custom_rng_seed(&r1, 42, 0);
+  custom_rng_seed(&r2, 42, 0);
+  custom_randu_v(&r1, a, 10000);
+  custom_randu_v(&r2, b, 4000);
+  custom_randu_v(&r2, b + 4000, 6000);
+  double mean = 0.0;
+  for (int i = 0; i < 10000; i++) {
+    ck_assert(a[i] > 0.0 && a[i] < 1.0);
+    ck_assert_double_eq(a[i], b[i]);
+    mean += a[i] / 10000;
+  }
+  ck_assert_double_eq_tol(mean, 0.5, 0.01);
+  ck_assert_int_eq(r1.counter, 10000);
+  custom_rng_seed(&r1, 42, 0);
+  custom_rng_seed(&r2, 42, 1);
+  uint64_t first = custom_rng_next(&r1);
+  ck_assert(first != custom_rng_next(&r2));
+  r1.counter = 0;
+  ck_assert(first == custom_rng_next(&r1));
+}
+END_TEST
+
+START_TEST(test_randn) {
+  static double x[100001];
+  custom_rng r;
+  custom_rng_seed(&r, 7, 3);
+  custom_randn_v(&r, x, 100001);
+  ck_assert_int_eq(r.counter, 100002);
+  double mean = 0.0, var = 0.0, below = 0.0;
+  for (int i = 0; i < 100001; i++) {
+    ck_assert(x[i] == x[i] && fabs(x[i]) < 10.0);
+    mean += x[i] / 100001;
+    var += x[i] * x[i] / 100001;
+    below += (x[i] < -1.0) / 100001.0;
+  }
+  ck_assert_double_eq_tol(mean, 0.0, 0.01);
+  ck_assert_double_eq_tol(var, 1.0, 0.02);
+  ck_assert_double_eq_tol(below, 0.158655, 0.005);
+}
+END_TEST
+
+START_TEST(test_rande) {
+  static double x[100000];
+  custom_rng r;
+  custom_rng_seed(&r, 7, 4);
+  custom_rande_v(&r, x, 100000, 2.0);
+  double mean = 0.0, above = 0.0;
+  for (int i = 0; i < 100000; i++) {
+    ck_assert(x[i] > 0.0 && x[i] < 30.0);
+    mean += x[i] / 100000;
+    above += (x[i] > 1.0) / 100000.0;
+  }
+  ck_assert_double_eq_tol(mean, 0.5, 0.01);
+  ck_assert_double_eq_tol(above, exp(-2.0), 0.005);
+  custom_rande_v(&r, x, 4, 0.0);
+  ck_assert_double_nan(x[0]);
+  custom_rande_v(&r, x, 4, -1.0);
+  ck_assert_double_nan(x[3]);
+}
+END_TEST
+
+START_TEST(test_randlogn) {
+  static double x[100000];
+  custom_rng r;
+  custom_rng_seed(&r, 7, 5);
+  custom_randlogn_v(&r, x, 100000, 1.0, 0.5);
+  double log_mean = 0.0, mean = 0.0;
+  for (int i = 0; i < 100000; i++) {
+    ck_assert(x[i] > 0.0);
+    log_mean += log(x[i]) / 100000;
+    mean += x[i] / 100000;
+  }
+  ck_assert_double_eq_tol(log_mean, 1.0, 0.01);
+  ck_assert_double_eq_tol(mean, exp(1.125), 0.03);
+}
+END_TEST
+
+START_TEST(test_exp_d1) {
+  double x[] = {-700.0, -3.5, -1e-9, 0.0, 0.7, 20.0, 700.0}, v[7], d[7];
+  custom_exp_d1_array(x, v, d, 7);
+  for (int i = 0; i < 7; i++) {
+    ck_assert_double_eq_tol(v[i], exp(x[i]), 1e-15 * exp(x[i]));
+    ck_assert_double_eq(d[i], v[i]);
+  }
+  custom_exp_d1(-INFINITY, v, d);
+  ck_assert_double_eq(v[0], 0.0);
+  ck_assert_double_eq(d[0], 0.0);
+}
+END_TEST
+
+START_TEST(test_log_d1) {
+  double x[] = {1e-300, 0.25, 1.0, 2.0, 123.456, 1e300}, v[6], d[6];
+  custom_log_d1_array(x, v, d, 6);
+  for (int i = 0; i < 6; i++) {
+    ck_assert_double_eq_tol(v[i], log(x[i]), 1e-15 * (1 + fabs(log(x[i]))));
+    ck_assert_double_eq_tol(d[i], 1.0 / x[i], 1e-15 / x[i]);
+  }
+  custom_log_d1(-1.0, v, d);
+  ck_assert_double_nan(v[0]);
+  ck_assert_double_nan(d[0]);
+  custom_log_d1(0.0, v, d);
+  ck_assert_double_eq(v[0], -INFINITY);
+  ck_assert_double_eq(d[0], INFINITY);
+}
+END_TEST
+
+START_TEST(test_sin_d1) {
+  for (double x = -20.0; x <= 20.0; x += 0.37) {
+    double v = 0.0, d = 0.0;
+    custom_sin_d1(x, &v, &d);
+    ck_assert_double_eq_tol(v, sin(x), 1e-15);
+    ck_assert_double_eq_tol(d, cos(x), 1e-15);
+  }
+  double x[] = {0.1, 1.0, 3.0}, out[3], d[3];
+  custom_sin_d1_array(x, out, d, 3);
+  for (int i = 0; i < 3; i++) ck_assert_double_eq_tol(d[i], cos(x[i]), 1e-15);
+}
+END_TEST
+
+START_TEST(test_cos_d1) {
+  for (double x = -20.0; x <= 20.0; x += 0.37) {
+    double v = 0.0, d = 0.0;
+    custom_cos_d1(x, &v, &d);
+    ck_assert_double_eq_tol(v, cos(x), 1e-15);
+    ck_assert_double_eq_tol(d, -sin(x), 1e-15);
+  }
+  double x[] = {0.1, 1.0, 3.0}, d[3];
+  custom_cos_d1_array(x, x, d, 3);
+  ck_assert_double_eq_tol(x[1], cos(1.0), 1e-15);
+  ck_assert_double_eq_tol(d[2], -sin(3.0), 1e-15);
+}
+END_TEST
+
+START_TEST(test_atan_d1) {
+  double x[] = {-1e10, -5.0, -1.0, 0.0, 0.3, 2.0, 1e100}, v[7], d[7];
+  custom_atan_d1_array(x, v, d, 7);
+  for (int i = 0; i < 7; i++) {
+    ck_assert_double_eq_tol(v[i], atan(x[i]), 1e-15);
+    ck_assert_double_eq_tol(d[i], 1.0 / (1.0 + x[i] * x[i]), 1e-15 * d[i]);
+  }
+}
+END_TEST
+
+START_TEST(test_sqrt_d1) {
+  double x[] = {1e-310, 1e-10, 0.5, 2.0, 1e300}, v[5], d[5];
+  custom_sqrt_d1_array(x, v, d, 5);
+  for (int i = 0; i < 5; i++) {
+    ck_assert_double_eq_tol(v[i], sqrt(x[i]), 1e-15 * sqrt(x[i]));
+    ck_assert_double_eq_tol(d[i], 0.5 / sqrt(x[i]), 1e-15 * d[i]);
+  }
+  custom_sqrt_d1(0.0, v, d);
+  ck_assert_double_eq(v[0], 0.0);
+  ck_assert_double_eq(d[0], INFINITY);
+  custom_sqrt_d1(-1.0, v, d);
+  ck_assert_double_nan(v[0]);
+  ck_assert_double_nan(d[0]);
+}
+END_TEST
+
+START_TEST(test_pow_d1) {
+  double x[] = {0.5, 2.0, 3.7, -2.0, 10.0}, y[] = {3.0, -1.5, 0.3, 3.0, 2.5};
+  double v[5], dx[5], dy[5];
+  custom_pow_d1_array(x, y, v, dx, dy, 5);
+  for (int i = 0; i < 5; i++) {
+    double p = pow(x[i], y[i]);
+    ck_assert_double_eq_tol(v[i], p, 1e-14 * fabs(p));
+    double ex = y[i] * pow(x[i], y[i] - 1.0);
+    ck_assert_double_eq_tol(dx[i], ex, 1e-14 * fabs(ex));
+    if (x[i] > 0) ck_assert_double_eq_tol(dy[i], p * log(x[i]), 1e-14 * p);
+  }
+  ck_assert_double_nan(dy[3]);
+  custom_pow_d1(0.0, 1.0, v, dx, dy);
+  ck_assert_double_eq(v[0], 0.0);
+  ck_assert_double_eq(dx[0], 1.0);
+  ck_assert_double_eq(dy[0], 0.0);
+  custom_pow_d1(0.0, 0.5, v, dx, dy);
+  ck_assert_double_eq(dx[0], INFINITY);
+  custom_pow_d1(0.0, 3.0, v, dx, dy);
+  ck_assert_double_eq(dx[0], 0.0);
+  custom_pow_d1(0.0, 0.0, v, dx, dy);
+  ck_assert_double_eq(v[0], 1.0);
+  ck_assert_double_eq(dx[0], 0.0);
+}
+END_TEST
+
+START_TEST(test_classify) {
+  double values[] = {0.0,     -0.0,     1.0,       -2.5, 5e-324, -1e-310,
+                     1.7e308, INFINITY, -INFINITY, NAN,  -NAN};
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    double x = values[i];
+    ck_assert_int_eq(custom_isnan(x), isnan(x) != 0);
+    ck_assert_int_eq(custom_isinf(x), isinf(x) != 0);
+    ck_assert_int_eq(custom_isfinite(x), isfinite(x) != 0);
+    ck_assert_int_eq(custom_signbit(x), signbit(x) != 0);
+  }
+}
+END_TEST
+
 Suite *math_suite(void) {
   Suite *s;
   TCase *tc_abs = NULL, *tc_fabs = NULL, *tc_floor = NULL, *tc_ceil = NULL,
         *tc_fmod = NULL, *tc_log = NULL, *tc_exp = NULL, *tc_factorial = NULL,
         *tc_pow = NULL, *tc_atan = NULL, *tc_acos = NULL, *tc_asin = NULL,
-        *tc_cos = NULL, *tc_sin = NULL, *tc_sqrt = NULL, *tc_tan = NULL;
+        *tc_cos = NULL, *tc_sin = NULL, *tc_sqrt = NULL, *tc_tan = NULL,
+        *tc_logsumexp = NULL, *tc_softmax = NULL, *tc_cexp = NULL,
+        *tc_clog = NULL, *tc_cpow = NULL, *tc_csin = NULL, *tc_ccos = NULL,
+        *tc_csqrt = NULL, *tc_sin_fixed = NULL, *tc_cos_fixed = NULL,
+        *tc_sqrt_fixed = NULL, *tc_exp_fixed = NULL, *tc_log_fixed = NULL,
+        *tc_atan2_fixed = NULL, *tc_expr = NULL, *tc_deterministic = NULL,
+        *tc_unchecked = NULL, *tc_tgamma = NULL, *tc_lgamma = NULL,
+        *tc_randu = NULL, *tc_randn = NULL, *tc_rande = NULL,
+        *tc_randlogn = NULL, *tc_exp_d1 = NULL, *tc_log_d1 = NULL,
+        *tc_sin_d1 = NULL, *tc_cos_d1 = NULL, *tc_atan_d1 = NULL,
+        *tc_sqrt_d1 = NULL, *tc_pow_d1 = NULL, *tc_classify = NULL;
 
   s = suite_create("custom_math");
 
@@ -346,6 +1153,16 @@ Suite *math_suite(void) {
   tcase_add_test(tc_factorial, test_factorial);
   suite_add_tcase(s, tc_factorial);
 
+  NAME_TEST("tgamma");
+  tc_tgamma = tcase_create("tgamma");
+  tcase_add_test(tc_tgamma, test_tgamma);
+  suite_add_tcase(s, tc_tgamma);
+
+  NAME_TEST("lgamma");
+  tc_lgamma = tcase_create("lgamma");
+  tcase_add_test(tc_lgamma, test_lgamma);
+  suite_add_tcase(s, tc_lgamma);
+
   NAME_TEST("pow");
   tc_pow = tcase_create("pow");
   tcase_add_test(tc_pow, test_pow);
@@ -386,6 +1203,151 @@ Suite *math_suite(void) {
   tcase_add_test(tc_tan, test_tan);
   suite_add_tcase(s, tc_tan);
 
+  NAME_TEST("logsumexp");
+  tc_logsumexp = tcase_create("logsumexp");
+  tcase_add_test(tc_logsumexp, test_logsumexp);
+  suite_add_tcase(s, tc_logsumexp);
+
+  NAME_TEST("softmax");
+  tc_softmax = tcase_create("softmax");
+  tcase_add_test(tc_softmax, test_softmax);
+  suite_add_tcase(s, tc_softmax);
+
+  NAME_TEST("cexp");
+  tc_cexp = tcase_create("cexp");
+  tcase_add_test(tc_cexp, test_cexp);
+  suite_add_tcase(s, tc_cexp);
+
+  NAME_TEST("clog");
+  tc_clog = tcase_create("clog");
+  tcase_add_test(tc_clog, test_clog);
+  suite_add_tcase(s, tc_clog);
+
+  NAME_TEST("cpow");
+  tc_cpow = tcase_create("cpow");
+  tcase_add_test(tc_cpow, test_cpow);
+  suite_add_tcase(s, tc_cpow);
+
+  NAME_TEST("csin");
+  tc_csin = tcase_create("csin");
+  tcase_add_test(tc_csin, test_csin);
+  suite_add_tcase(s, tc_csin);
+
+  NAME_TEST("ccos");
+  tc_ccos = tcase_create("ccos");
+  tcase_add_test(tc_ccos, test_ccos);
+  suite_add_tcase(s, tc_ccos);
+
+  NAME_TEST("csqrt");
+  tc_csqrt = tcase_create("csqrt");
+  tcase_add_test(tc_csqrt, test_csqrt);
+  suite_add_tcase(s, tc_csqrt);
+
+  NAME_TEST("sin_q16 / custom_sin_q31");
+  tc_sin_fixed = tcase_create("sin_fixed");
+  tcase_add_test(tc_sin_fixed, test_sin_fixed);
+  suite_add_tcase(s, tc_sin_fixed);
+
+  NAME_TEST("cos_q16 / custom_cos_q31");
+  tc_cos_fixed = tcase_create("cos_fixed");
+  tcase_add_test(tc_cos_fixed, test_cos_fixed);
+  suite_add_tcase(s, tc_cos_fixed);
+
+  NAME_TEST("sqrt_q16 / custom_sqrt_q31");
+  tc_sqrt_fixed = tcase_create("sqrt_fixed");
+  tcase_add_test(tc_sqrt_fixed, test_sqrt_fixed);
+  suite_add_tcase(s, tc_sqrt_fixed);
+
+  NAME_TEST("exp_q16 / custom_exp_q31");
+  tc_exp_fixed = tcase_create("exp_fixed");
+  tcase_add_test(tc_exp_fixed, test_exp_fixed);
+  suite_add_tcase(s, tc_exp_fixed);
+
+  NAME_TEST("log_q16 / custom_log_q31");
+  tc_log_fixed = tcase_create("log_fixed");
+  tcase_add_test(tc_log_fixed, test_log_fixed);
+  suite_add_tcase(s, tc_log_fixed);
+
+  NAME_TEST("atan2_q16 / custom_atan2_q31");
+  tc_atan2_fixed = tcase_create("atan2_fixed");
+  tcase_add_test(tc_atan2_fixed, test_atan2_fixed);
+  suite_add_tcase(s, tc_atan2_fixed);
+
+  NAME_TEST("expr_build / custom_expr_eval");
+  tc_expr = tcase_create("expr");
+  tcase_add_test(tc_expr, test_expr);
+  suite_add_tcase(s, tc_expr);
+
+  NAME_TEST("set_deterministic");
+  tc_deterministic = tcase_create("deterministic");
+  tcase_add_test(tc_deterministic, test_deterministic);
+  suite_add_tcase(s, tc_deterministic);
+
+  NAME_TEST("sin_reduced / custom_exp_small / custom_sqrt_finite");
+  tc_unchecked = tcase_create("unchecked");
+  tcase_add_test(tc_unchecked, test_unchecked);
+  suite_add_tcase(s, tc_unchecked);
+
+  NAME_TEST("rng_seed / custom_rng_next / custom_randu_v");
+  tc_randu = tcase_create("randu");
+  tcase_add_test(tc_randu, test_randu);
+  suite_add_tcase(s, tc_randu);
+
+  NAME_TEST("randn_v");
+  tc_randn = tcase_create("randn");
+  tcase_add_test(tc_randn, test_randn);
+  suite_add_tcase(s, tc_randn);
+
+  NAME_TEST("rande_v");
+  tc_rande = tcase_create("rande");
+  tcase_add_test(tc_rande, test_rande);
+  suite_add_tcase(s, tc_rande);
+
+  NAME_TEST("randlogn_v");
+  tc_randlogn = tcase_create("randlogn");
+  tcase_add_test(tc_randlogn, test_randlogn);
+  suite_add_tcase(s, tc_randlogn);
+
+  NAME_TEST("exp_d1 / custom_exp_d1_array");
+  tc_exp_d1 = tcase_create("exp_d1");
+  tcase_add_test(tc_exp_d1, test_exp_d1);
+  suite_add_tcase(s, tc_exp_d1);
+
+  NAME_TEST("log_d1 / custom_log_d1_array");
+  tc_log_d1 = tcase_create("log_d1");
+  tcase_add_test(tc_log_d1, test_log_d1);
+  suite_add_tcase(s, tc_log_d1);
+
+  NAME_TEST("sin_d1 / custom_sin_d1_array");
+  tc_sin_d1 = tcase_create("sin_d1");
+  tcase_add_test(tc_sin_d1, test_sin_d1);
+  suite_add_tcase(s, tc_sin_d1);
+
+  NAME_TEST("cos_d1 / custom_cos_d1_array");
+  tc_cos_d1 = tcase_create("cos_d1");
+  tcase_add_test(tc_cos_d1, test_cos_d1);
+  suite_add_tcase(s, tc_cos_d1);
+
+  NAME_TEST("atan_d1 / custom_atan_d1_array");
+  tc_atan_d1 = tcase_create("atan_d1");
+  tcase_add_test(tc_atan_d1, test_atan_d1);
+  suite_add_tcase(s, tc_atan_d1);
+
+  NAME_TEST("sqrt_d1 / custom_sqrt_d1_array");
+  tc_sqrt_d1 = tcase_create("sqrt_d1");
+  tcase_add_test(tc_sqrt_d1, test_sqrt_d1);
+  suite_add_tcase(s, tc_sqrt_d1);
+
+  NAME_TEST("pow_d1 / custom_pow_d1_array");
+  tc_pow_d1 = tcase_create("pow_d1");
+  tcase_add_test(tc_pow_d1, test_pow_d1);
+  suite_add_tcase(s, tc_pow_d1);
+
+  NAME_TEST("isnan / custom_isinf / custom_isfinite / custom_signbit");
+  tc_classify = tcase_create("classify");
+  tcase_add_test(tc_classify, test_classify);
+  suite_add_tcase(s, tc_classify);
+
   return s;
 }
 